@@ -26,6 +26,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "Monitor_usart.h"
+#include "bench.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -93,6 +94,10 @@ int main(void)
   MX_USART1_UART_Init();
   MX_SPI1_Init();
   /* USER CODE BEGIN 2 */
+#if MONITOR_BENCH
+  Bench_Run();   // ADC_Bench 目标：上电跑完基准测试后停在这里
+  while (1) {}
+#endif
 Monitor_Init();
 
   /* USER CODE END 2 */
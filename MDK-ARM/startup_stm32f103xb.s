@@ -32,6 +32,7 @@
 Stack_Size		EQU     0x400
 
                 AREA    STACK, NOINIT, READWRITE, ALIGN=3
+                EXPORT  Stack_Mem                  ; stack bottom, scanned by stack_watch.c
 Stack_Mem       SPACE   Stack_Size
 __initial_sp
 
@@ -129,6 +130,15 @@ Reset_Handler    PROC
                  EXPORT  Reset_Handler             [WEAK]
      IMPORT  __main
      IMPORT  SystemInit
+                 ; Paint the whole stack with 0xA5A5A5A5 (nothing is on it yet) for stack_watch.c
+                 LDR     R0, =Stack_Mem
+                 LDR     R1, =__initial_sp
+                 LDR     R2, =0xA5A5A5A5
+Paint_Loop       CMP     R0, R1
+                 BHS     Paint_Done
+                 STR     R2, [R0], #4
+                 B       Paint_Loop
+Paint_Done
                  LDR     R0, =SystemInit
                  BLX     R0
                  LDR     R0, =__main
@@ -2,15 +2,34 @@
  * Monitor_usart.c
  * 2026-01-15 最终修正版
  * 功能：
- * 1. 协议解析：FC 0A 00 01 开头，0-100度有效范围过滤。
+ * 0. 全程无浮点：温度用 int16 (0.1度)，时间用 uint32 毫秒 (M3 没有 FPU，浮点全靠软件库)。
+ * 1. 协议解析：FC | 长度 | CMD | 内容 | XOR 整帧校验后分发；
+ *    CMD 01 长度 10 为温度帧，0-100度有效范围过滤；CMD 70 导出事件跟踪；CMD 71 返回性能分析表；
+ *    CMD 72 返回诊断信息 (栈高水位、收帧计数)；CMD 74 返回/清零 ADC 直方图。
  * 2. ADC采样：每50ms采集一次，打印时取0.25s内的中值。
+ *    采集方式、滤波、窗口、输出格式在 monitor_pipeline.h 里编译期选择，这里只编译选中的实现。
  * 3. 时序控制：
  * - 收到第一帧有效温度 -> 同步开始 (Start ADC)。
  * - 延时0.25s (等待数据积攒) -> 第一次打印 (标记为 0.00s)。
  * - 之后每0.25s打印一次。
+ * 4. 多传感器：每个实例 (Monitor_t) 绑定一个传感器串口和一路 ADC 通道，状态全在实例里，
+ *    实例表 monitor_cfg 编译期定长；报告统一从 USART1 发出，多实例时行首带 "S编号 "。
  */
 
 #include "Monitor_usart.h"
+#include "monitor_pipeline.h"
+#include "win_stats.h"
+#include "xcorr.h"
+#include "thermal_model.h"
+#include "align.h"
+#include "drift.h"
+#include "thermocouple.h"
+#include "trace.h"
+#include "profile.h"
+#include "stack_watch.h"
+#include "histogram.h"
+#include "ramfunc.h"
+#include "hw_io.h"
 #include "usart.h"
 #include "adc.h"
 #include "stdio.h"
@@ -20,63 +39,254 @@
 // 引用外部句柄
 extern UART_HandleTypeDef huart1;
 extern ADC_HandleTypeDef hadc1;
+#if MONITOR_INSTANCES > 1
+extern UART_HandleTypeDef huart3;
+#endif
+#if MONITOR_INSTANCES > 2
+extern UART_HandleTypeDef huart2;
+#endif
 
 // ================= 宏定义与配置 =================
-#define PRINT_INTERVAL_MS   250   // 打印周期 250ms
-#define ADC_SAMPLE_MS       50    // ADC采样周期 50ms
+#define PRINT_INTERVAL_MS   MONITOR_WINDOW_MS   // 打印周期 250ms
+#define ADC_SAMPLE_MS       MONITOR_SAMPLE_MS   // ADC采样周期 50ms
 #define LED_TOGGLE_MS       15000 // LED翻转周期 15s
-#define TEMP_MIN            0.0f
-#define TEMP_MAX            100.0f
+#define STACK_SCAN_MS       1000  // 栈高水位扫描周期 1s
+#define TEMP_MIN_DECI       0     // 有效温度下限 0.0度 (单位 0.1度)
+#define TEMP_MAX_DECI       1000  // 有效温度上限 100.0度
 
 // ADC 窗口大小 (250ms / 50ms = 5，预留多一点防止溢出)
-#define MAX_ADC_SAMPLES     10    
+#define MAX_ADC_SAMPLES     MONITOR_WINDOW_SAMPLES
+
+// 延迟测量模式：温度帧第 7、8 字节 (第二个温度字) 被流量发生器换成帧序号，
+// 打开后报告行末尾带上 ", M:序号"，上位机 latency 工具据此算端到端延迟。
+// 接真实传感器时保持 0。
+#ifndef MONITOR_LATENCY_MARK
+#define MONITOR_LATENCY_MARK 0
+#endif
+
+#if MONITOR_ACQ == MONITOR_ACQ_REG && MONITOR_INSTANCES > 1
+#error "MONITOR_ACQ_REG 只支持单实例 (多实例要切通道，用 MONITOR_ACQ_HAL)"
+#endif
+
+// 多出来的实例在配对表里是全 0，Monitor_Init 会拿空句柄开接收
+#if MONITOR_INSTANCES > 3
+#error "monitor_cfg 只有 3 行，先补配对表"
+#endif
+
+// 接收帧缓冲：只收本程序关心的短帧，更长的 (IAP 数据包等) 直接丢弃重新找帧头
+#define RX_FRAME_MAX        16
+#define TEMP_FRAME_LEN      10    // FC 0A 00 01 [T LSB MSB][T2 LSB MSB] 00 XOR
 
 // 协议状态机
 typedef enum {
     STATE_WAIT_FC,       // 等待帧头 FC
-    STATE_CHECK_LEN,     // 检查 0A
-    STATE_CHECK_ZERO,    // 检查 00
-    STATE_CHECK_STATUS,  // 检查 01
-    STATE_READ_DATA      // 读取数据
+    STATE_LEN_L,         // 长度低字节
+    STATE_LEN_H,         // 长度高字节
+    STATE_BODY           // CMD + 内容 + XOR
 } ProtocolState_t;
 
-// ================= 全局变量 =================
+// 需要主循环处理的请求 (中断里只置位)
+#define REQ_TRACE_DUMP      0x01
+#define REQ_PROF_DUMP       0x02
+#define REQ_PROF_RESET      0x04   // 返回性能分析表后清零
+#define REQ_DIAG            0x08
+#define REQ_HIST_DUMP       0x10
+#define REQ_HIST_RESET      0x20   // 单独出现时只清零，和 DUMP 一起时返回后清零
+
+// 诊断帧格式版本，字段只在末尾追加，追加时加 1
+#define DIAG_VERSION        2
+
+// 实例配置：传感器串口 + 配对的 ADC 通道
+typedef struct {
+    UART_HandleTypeDef *huart;
+    ADC_HandleTypeDef  *hadc;
+    uint32_t            adc_channel;   // ADC_CHANNEL_x，单实例时沿用 MX_ADC1_Init 的配置
+} MonitorConfig_t;
+
+// 一次报告的内容，由输出策略编码
+typedef struct {
+    uint8_t  sensor;      // 实例编号，从 0 起
+    int32_t  t_cs;        // 相对时间 (0.01s)
+    int16_t  temp_deci;   // 温度 (0.1度)
+    uint32_t adc;         // 窗口内 ADC 滤波值
+#if MONITOR_LATENCY_MARK
+    uint16_t mark;        // 温度帧序号
+#endif
+#if MONITOR_STATS
+    WinStats_t adc_stats;     // 窗口内 ADC 原始值统计
+    WinStats_t temp_stats;    // 窗口内温度统计 (0.1度)
+#endif
+#if MONITOR_DEADBAND
+    uint16_t suppressed;      // 上次报告之后被死区压掉的窗口数
+#endif
+#if MONITOR_XCORR
+    int16_t  lag_ms;          // ADC 比温度晚多少毫秒
+    int8_t   lag_rho;         // 该延迟上的相关系数 x100，0 表示还没有可用的变化
+#endif
+#if MONITOR_PREDICT
+    int16_t  pred_deci;       // 预测的稳态温度 (0.1度)
+    uint16_t tau_ms;          // 时间常数，0 表示还没辨识出来
+#endif
+#if MONITOR_ALIGN
+    AlignResult_t align;      // 上次报告以来对齐好的 (ADC, 温度) 平均
+#endif
+#if MONITOR_DRIFT
+    uint16_t drift_n;         // 已拟合帧数
+    uint32_t period_us;       // 传感器帧周期 (本机 us)
+    int32_t  ppm_x10;         // 漂移 x10，未锁定为 0
+    uint16_t jitter_us;       // 帧到达抖动
+    uint16_t drift_outliers;  // 被截断或跳过的帧
+#endif
+#if MONITOR_TC
+    int16_t  tc_deci;         // 热电偶温度 (0.1度)
+    uint8_t  tc_fault;        // 热电偶故障位，0 表示读数有效
+#endif
+} MonitorReport_t;
+
+// 每个传感器一份的运行状态
+struct Monitor_s {
+    const MonitorConfig_t *cfg;
+    uint8_t index;
 
-// --- 接收与解析 ---
-static uint8_t rx_byte;
-static ProtocolState_t p_state = STATE_WAIT_FC;
-static uint8_t data_buf[6];      
-static uint8_t data_idx = 0;
+    // --- 接收与解析 (中断) ---
+    uint8_t rx_byte;
+    ProtocolState_t p_state;
+    uint8_t frame_buf[RX_FRAME_MAX];
+    uint16_t frame_len;
+    uint16_t frame_idx;
 
-// --- 数据资源 (临界区保护) ---
-static volatile float g_latest_valid_temp = 0.0f; 
-static volatile uint8_t g_has_valid_data = 0;     
+    // --- 诊断计数 ---
+    volatile uint32_t rx_frames;        // XOR 正确的帧
+    volatile uint32_t rx_bad_xor;       // 长度合理但 XOR 错
+    volatile uint32_t uart_errors;      // 串口错误回调次数
 
-// --- ADC 相关 ---
-static uint32_t adc_values[MAX_ADC_SAMPLES];
-static uint8_t adc_count = 0;
-static uint32_t next_adc_tick = 0;
+    // --- 数据资源 (临界区保护) ---
+    volatile int16_t latest_temp_deci;  // 最新有效温度 (0.1度)
+    volatile uint8_t has_valid_data;
+#if MONITOR_LATENCY_MARK
+    volatile uint16_t latest_mark;      // 提供最新温度那一帧的序号
+#endif
+#if MONITOR_STATS
+    WinStats_t temp_stats;              // 本窗口收到的温度 (中断里累加，取走时关中断)
+#endif
+#if MONITOR_PREDICT
+    ThermalModel_t thermal;             // 中断里逐帧辨识，取快照时关中断
+#endif
+#if MONITOR_ALIGN
+    volatile uint16_t tf_seq;           // 有效温度帧计数，主循环据此发现新帧
+    int16_t  tf_temp[2];                // 前一帧、最新一帧温度 (0.1度)
+    uint32_t tf_tick[2];                // 对应的到达时刻
+#endif
+#if MONITOR_DRIFT
+    Drift_t drift;                      // 中断里逐帧更新，取快照时关中断
+#endif
+
+    // --- ADC 相关 (累加状态随滤波策略) ---
+#if MONITOR_FILTER == MONITOR_FILTER_MEDIAN
+    uint32_t adc_values[MAX_ADC_SAMPLES];
+#elif MONITOR_FILTER == MONITOR_FILTER_MEAN
+    uint32_t adc_sum;
+#else
+    uint32_t adc_last;
+#endif
+    uint8_t adc_count;
+#if MONITOR_STATS
+    WinStats_t adc_stats;
+#endif
+    uint32_t next_adc_tick;
+
+#if MONITOR_XCORR
+    XCorr_t xcorr;                      // 每窗口一对 (ADC, 温度)，主循环独占
+#endif
+
+#if MONITOR_ALIGN
+    Align_t align;                      // 挂起的 ADC 样本和配好的对，主循环独占
+    uint16_t tf_seen;                   // 已交给 align 的温度帧计数
+#endif
+
+#if MONITOR_DEADBAND
+    // --- 变化报告 ---
+    uint8_t  reported;                  // 同步后是否已发过报告
+    int16_t  last_temp_deci;            // 上次发出的温度
+    uint32_t last_adc;                  // 上次发出的 ADC
+    uint32_t last_report_tick;
+    uint16_t suppressed;
+#endif
+
+    // --- 时间轴 ---
+    uint8_t time_synced;                // 是否收到第一帧
+    uint32_t time_base_tick;            // 0.00s 对应的时刻
+    uint32_t next_print_tick;
+};
+
+// ================= 实例表 =================
+// 加传感器：CubeMX 里打开串口 (开中断) 和 ADC 通道，MONITOR_INSTANCES 加 1，在这里补一行
+// (超过 3 个时同时改上面的 #error 上限)。
+// 本板 PA1~PA4 是 LED1/LED2/BOTTON1/BOTTON2，PA5~PA7 给了 SPI1：
+// 第二路建议 USART3 (PB10/PB11) + ADC_CHANNEL_8 (PB0)；USART2 在 PA2/PA3，要先让出 LED2/BOTTON1。
+static const MonitorConfig_t monitor_cfg[MONITOR_INSTANCES] = {
+    { &huart1, &hadc1, ADC_CHANNEL_0 },   // PA0
+#if MONITOR_INSTANCES > 1
+    { &huart3, &hadc1, ADC_CHANNEL_8 },   // PB0
+#endif
+#if MONITOR_INSTANCES > 2
+    { &huart2, &hadc1, ADC_CHANNEL_9 },   // PB1
+#endif
+};
+
+// ================= 全局变量 =================
 
-// --- 系统控制 ---
+// --- 各传感器实例 ---
+static Monitor_t monitors[MONITOR_INSTANCES];
+
+// --- 上位机请求 (任一串口收到都算) ---
+static volatile uint8_t g_requests = 0;
+
+// --- 系统控制 (全部实例共用) ---
 static uint8_t is_running = 1;              // 1:Start, 0:Stop
 // static uint8_t last_btn_state;           // 已移除，避免未使用警告
 
-// --- 时间轴 ---
-static uint8_t time_synced = 0;             // 是否收到第一帧
-static uint32_t time_base_tick = 0;         // 0.00s 对应的时刻
-static uint32_t next_print_tick = 0;        
+// --- 板级定时 ---
 static uint32_t next_led_tick = 0;
+static uint32_t next_stack_tick = 0;
 
 // ================= 内部辅助函数 =================
 
+// ================= 流水线策略：滤波 =================
+// Filter_Add 每个样本调一次，Filter_Result 在打印时取窗口结果，Filter_Reset 开始新窗口
+
+static __inline void Filter_Reset(Monitor_t *m) {
+    m->adc_count = 0;
+#if MONITOR_STATS
+    WinStats_Reset(&m->adc_stats);
+#endif
+#if MONITOR_FILTER == MONITOR_FILTER_MEAN
+    m->adc_sum = 0;
+#endif
+}
+
+static __inline void Filter_Add(Monitor_t *m, uint32_t val) {
+    if (m->adc_count >= MAX_ADC_SAMPLES) return;
+#if MONITOR_FILTER == MONITOR_FILTER_MEDIAN
+    m->adc_values[m->adc_count] = val;
+#elif MONITOR_FILTER == MONITOR_FILTER_MEAN
+    m->adc_sum += val;
+#else
+    m->adc_last = val;
+#endif
+    m->adc_count++;
+}
+
+#if MONITOR_FILTER == MONITOR_FILTER_MEDIAN
 // 简单的冒泡排序用于取中值 (数量很少，性能无影响)
-static uint32_t Get_Median_ADC(void) {
-    if (adc_count == 0) return 0;
+static uint32_t Filter_Result(const Monitor_t *m) {
+    if (m->adc_count == 0) return 0;
+    PROF_BEGIN(MEDIAN);
     
     // 复制一份数据以防修改原数组 (虽然还要重置，习惯上复制更安全)
     uint32_t sorted[MAX_ADC_SAMPLES];
-    uint8_t n = adc_count;
-    for(int i=0; i<n; i++) sorted[i] = adc_values[i];
+    uint8_t n = m->adc_count;
+    for(int i=0; i<n; i++) sorted[i] = m->adc_values[i];
     
     // 冒泡排序
     for(int i=0; i<n-1; i++) {
@@ -88,22 +298,40 @@ static uint32_t Get_Median_ADC(void) {
             }
         }
     }
+    PROF_END(MEDIAN);
     // 返回中位数
     return sorted[n/2];
 }
+#elif MONITOR_FILTER == MONITOR_FILTER_MEAN
+static __inline uint32_t Filter_Result(const Monitor_t *m) {
+    return m->adc_count ? (m->adc_sum + m->adc_count / 2) / m->adc_count : 0;
+}
+#else
+static __inline uint32_t Filter_Result(const Monitor_t *m) {
+    return m->adc_count ? m->adc_last : 0;
+}
+#endif
+
+// 更新温度 (中断调用)，data 指向温度帧数据区 (LSB, MSB, 第二个温度字...)
+static RAMFUNC void Update_Temperature(Monitor_t *m, const uint8_t *data) {
+    uint16_t raw = (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+    int16_t deci = (int16_t)raw;   // 最高位为 1 的当负数，落在下限之外
 
-// 更新温度 (中断调用)
-static void Update_Temperature(uint8_t lsb, uint8_t msb) {
-    uint16_t raw = (uint16_t)lsb | ((uint16_t)msb << 8);
-    float val = raw / 10.0f;
+#if MONITOR_DRIFT
+    Drift_Add(&m->drift, HAL_GetTick());   // 温度无效的帧也是按传感器时钟发的
+#endif
 
-    if (val >= TEMP_MIN && val <= TEMP_MAX) {
-        g_latest_valid_temp = val;
-        g_has_valid_data = 1;
+    if (deci >= TEMP_MIN_DECI && deci <= TEMP_MAX_DECI) {
+        m->latest_temp_deci = deci;
+        m->has_valid_data = 1;
+#if MONITOR_LATENCY_MARK
+        m->latest_mark = (uint16_t)data[2] | ((uint16_t)data[3] << 8);
+#endif
+        TRACE(TEMP, raw, 1);
         
         // 收到系统生命周期内的第一帧有效数据 -> 建立时间轴
-        if (is_running && !time_synced) {
-            time_synced = 1;
+        if (is_running && !m->time_synced) {
+            m->time_synced = 1;
             uint32_t now = HAL_GetTick();
             
             // 关键逻辑：用户要求“采集到第二个温度时才算作第0s”
@@ -111,24 +339,529 @@ static void Update_Temperature(uint8_t lsb, uint8_t msb) {
             // 现在的时刻是 (Frame 1 Arrival)，第一次打印将在 (Frame 1 + 250ms)。
             // 所以我们将 time_base_tick 设为 (now + 250)。
             // 这样在 250ms 后打印时，(Tick - time_base) = 0。
-            time_base_tick = now + PRINT_INTERVAL_MS;
+            m->time_base_tick = now + PRINT_INTERVAL_MS;
             
             // 安排下一次打印和ADC采样
-            next_print_tick = now + PRINT_INTERVAL_MS;
-            next_adc_tick = now; // 立即开始采样ADC
+            m->next_print_tick = now + PRINT_INTERVAL_MS;
+            m->next_adc_tick = now; // 立即开始采样ADC
+#if MONITOR_STATS
+            WinStats_Reset(&m->temp_stats);   // 丢掉停止期间攒下的
+#endif
+#if MONITOR_DEADBAND
+            m->reported = 0;                  // 新时间轴的第一份报告照发
+#endif
+#if MONITOR_PREDICT
+            Thermal_Reset(&m->thermal);
+#endif
+#if MONITOR_ALIGN
+            m->tf_temp[1] = deci;             // 没有前一帧：下面移位后两帧相同
+            m->tf_tick[1] = now;
+#endif
+            TRACE(SYNC, m->index, now);
         }
+#if MONITOR_STATS
+        WinStats_Add(&m->temp_stats, deci);
+#endif
+#if MONITOR_PREDICT
+        Thermal_Add(&m->thermal, deci, HAL_GetTick());
+#endif
+#if MONITOR_ALIGN
+        m->tf_temp[0] = m->tf_temp[1];
+        m->tf_tick[0] = m->tf_tick[1];
+        m->tf_temp[1] = deci;
+        m->tf_tick[1] = HAL_GetTick();
+        m->tf_seq++;
+#endif
+    } else {
+        TRACE(TEMP, raw, 0);
+    }
+}
+
+// 整帧校验通过后分发 (中断调用)
+static RAMFUNC void Dispatch_Frame(Monitor_t *m, const uint8_t *frame, uint16_t len) {
+    switch (frame[3]) {
+        case MONITOR_CMD_TEMP:
+            // 长度 5 的是上位机请求帧，忽略
+            if (len == TEMP_FRAME_LEN) Update_Temperature(m, &frame[4]);
+            break;
+
+        case MONITOR_CMD_TRACE:
+            g_requests |= REQ_TRACE_DUMP;
+            break;
+
+        case MONITOR_CMD_DIAG:
+            g_requests |= REQ_DIAG;
+            break;
+
+        case MONITOR_CMD_PROFILE:
+            g_requests |= REQ_PROF_DUMP;
+            if (len == 6 && frame[4] == 0x01) g_requests |= REQ_PROF_RESET;
+            break;
+
+        case MONITOR_CMD_HIST:
+            if (len == 6 && frame[4] == 0x02) {
+                g_requests |= REQ_HIST_RESET;
+            } else {
+                g_requests |= REQ_HIST_DUMP;
+                if (len == 6 && frame[4] == 0x01) g_requests |= REQ_HIST_RESET;
+            }
+            break;
+
+        default:
+            // 传感器与上位机之间的其它指令，嗅探端不处理
+            break;
+    }
+}
+
+static uint8_t *Put_U16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *Put_U32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+// 诊断帧 (CMD 0x72，小端)：
+//   版本(1) 运行时间ms(4) 栈总字节(2) 栈最深用量(2) 收帧数(4) XOR错帧数(4) 串口错误数(4)  <- v1，计数为全部实例之和
+//   实例数(1) + 每实例 [收帧数(4) XOR错帧数(4) 串口错误数(4)]                              <- v2 追加
+static void Send_Diagnostics(void) {
+    uint8_t payload[22 + MONITOR_INSTANCES * 12];
+    uint8_t *p = payload;
+    uint32_t frames = 0, bad = 0, errors = 0;
+
+    for (uint8_t i = 0; i < MONITOR_INSTANCES; i++) {
+        frames += monitors[i].rx_frames;
+        bad += monitors[i].rx_bad_xor;
+        errors += monitors[i].uart_errors;
+    }
+
+    Stack_Watch_Scan();
+    *p++ = DIAG_VERSION;
+    p = Put_U32(p, HAL_GetTick());
+    p = Put_U16(p, Stack_Watch_Size());
+    p = Put_U16(p, Stack_Watch_Peak());
+    p = Put_U32(p, frames);
+    p = Put_U32(p, bad);
+    p = Put_U32(p, errors);
+    *p++ = MONITOR_INSTANCES;
+    for (uint8_t i = 0; i < MONITOR_INSTANCES; i++) {
+        p = Put_U32(p, monitors[i].rx_frames);
+        p = Put_U32(p, monitors[i].rx_bad_xor);
+        p = Put_U32(p, monitors[i].uart_errors);
+    }
+    Monitor_Send_Frame(MONITOR_CMD_DIAG, payload, (uint16_t)(p - payload));
+}
+
+// 按串口句柄找实例 (中断调用，实例很少，直接顺序找)
+static RAMFUNC Monitor_t *Find_Monitor(UART_HandleTypeDef *huart) {
+    for (uint8_t i = 0; i < MONITOR_INSTANCES; i++) {
+        if (monitor_cfg[i].huart == huart) return &monitors[i];
+    }
+    return 0;
+}
+
+// ================= 流水线策略：采集 =================
+// 读一次配对的 ADC 通道，成功返回 1
+
+#if MONITOR_ACQ == MONITOR_ACQ_HAL
+static uint8_t Read_ADC(const MonitorConfig_t *cfg, uint32_t *val) {
+#if MONITOR_INSTANCES > 1
+    // 多实例共用 ADC1：每次先切通道，读完停下 (连续模式不停就换不了通道)
+    ADC_ChannelConfTypeDef ch = {0};
+    ch.Channel = cfg->adc_channel;
+    ch.Rank = ADC_REGULAR_RANK_1;
+    ch.SamplingTime = ADC_SAMPLETIME_28CYCLES_5;
+    HAL_ADC_ConfigChannel(cfg->hadc, &ch);
+#endif
+    uint8_t ok = 0;
+    HAL_ADC_Start(cfg->hadc);
+    if (HAL_ADC_PollForConversion(cfg->hadc, 10) == HAL_OK) {
+        *val = ADC_VALUE(cfg->hadc->Instance);
+        ok = 1;
+    }
+#if MONITOR_INSTANCES > 1
+    HAL_ADC_Stop(cfg->hadc);
+#endif
+    return ok;
+}
+#else
+// Monitor_Init 里已启动连续转换，这里不等待：没有新结果就跳过这一拍
+static __inline uint8_t Read_ADC(const MonitorConfig_t *cfg, uint32_t *val) {
+    if (!ADC_EOC(cfg->hadc->Instance)) return 0;
+    *val = ADC_VALUE(cfg->hadc->Instance);
+    return 1;
+}
+#endif
+
+// ================= 流水线策略：输出 =================
+// 返回发出的字节数 (给事件跟踪用)
+
+#if MONITOR_FORMAT == MONITOR_FORMAT_TEXT
+// 行长上限：基本字段 64，各可选字段按最长的写法预留
+#define REPORT_TEXT_MAX     (64 + 80 * MONITOR_STATS + 24 * MONITOR_PREDICT + 20 * MONITOR_XCORR + 28 * MONITOR_ALIGN + \
+                             48 * MONITOR_DRIFT + 20 * MONITOR_TC + 12 * MONITOR_DEADBAND)
+
+static uint16_t Emit_Report(const MonitorReport_t *r) {
+    // 毫秒已四舍五入到 0.01s，负数单独带符号，防止出现 -0.00
+    uint32_t abs_cs = (uint32_t)((r->t_cs < 0) ? -r->t_cs : r->t_cs);
+    const char *sign = (r->t_cs < 0) ? "-" : "";
+
+    // 温度已限定 0~1000，不会是负数
+    char msg[REPORT_TEXT_MAX];
+    int n = 0;
+    PROF_BEGIN(FORMAT);
+#if MONITOR_INSTANCES > 1
+    n = sprintf(msg, "S%u ", (unsigned)(r->sensor + 1));
+#endif
+#if MONITOR_LATENCY_MARK
+    // 格式: [时间s] T:温度 C, ADC:值, M:帧序号
+    n += sprintf(msg + n, "[%s%lu.%02lus] T:%d.%d C, ADC:%lu, M:%u", 
+                 sign, (unsigned long)(abs_cs / 100), (unsigned long)(abs_cs % 100),
+                 r->temp_deci / 10, r->temp_deci % 10, (unsigned long)r->adc, r->mark);
+#else
+    // 格式: [时间s] T:温度 C, ADC:值
+    n += sprintf(msg + n, "[%s%lu.%02lus] T:%d.%d C, ADC:%lu", 
+                 sign, (unsigned long)(abs_cs / 100), (unsigned long)(abs_cs % 100),
+                 r->temp_deci / 10, r->temp_deci % 10, (unsigned long)r->adc);
+#endif
+#if MONITOR_STATS
+    {
+        // 窗口统计: AS:个数/最小/最大/均值/标准差 (ADC 码)，TS: 同上 (度，均值和标准差多一位小数)
+        const WinStats_t *a = &r->adc_stats, *t = &r->temp_stats;
+        int32_t am = WinStats_Mean10(a), tm = WinStats_Mean10(t);
+        uint32_t asd = WinStats_Sd10(a), tsd = WinStats_Sd10(t);
+        if (t->n == 0) tm = 0;
+        n += sprintf(msg + n, ", AS:%u/%d/%d/%ld.%ld/%lu.%lu, TS:%u/%d.%d/%d.%d/%ld.%02ld/%lu.%02lu",
+                     a->n, a->n ? a->min : 0, a->n ? a->max : 0, (long)(am / 10), (long)(am % 10),
+                     (unsigned long)(asd / 10), (unsigned long)(asd % 10),
+                     t->n, t->n ? t->min / 10 : 0, t->n ? t->min % 10 : 0, t->n ? t->max / 10 : 0, t->n ? t->max % 10 : 0,
+                     (long)(tm / 100), (long)(tm % 100), (unsigned long)(tsd / 100), (unsigned long)(tsd % 100));
+    }
+#endif
+#if MONITOR_PREDICT
+    // PT: 预测稳态温度，TAU: 时间常数 ms
+    n += sprintf(msg + n, ", PT:%d.%d C, TAU:%u", r->pred_deci / 10, r->pred_deci % 10, r->tau_ms);
+#endif
+#if MONITOR_XCORR
+    // LAG: ADC 相对温度的延迟 毫秒/相关系数%
+    n += sprintf(msg + n, ", LAG:%d/%d", r->lag_ms, r->lag_rho);
+#endif
+#if MONITOR_ALIGN
+    // AL: 对齐的 对数/ADC 均值/温度均值 (0.01度)/过期个数
+    n += sprintf(msg + n, ", AL:%u/%lu.%lu/%ld.%02ld/%u", r->align.n,
+                 (unsigned long)(r->align.adc_x10 / 10), (unsigned long)(r->align.adc_x10 % 10),
+                 (long)(r->align.temp_centi / 100), (long)(r->align.temp_centi % 100), r->align.stale);
+#endif
+#if MONITOR_DRIFT
+    {
+        // DR: 拟合帧数/帧周期 us/漂移 ppm/抖动 us/截断帧数
+        uint32_t abs_ppm = (uint32_t)((r->ppm_x10 < 0) ? -r->ppm_x10 : r->ppm_x10);
+        n += sprintf(msg + n, ", DR:%u/%lu/%s%lu.%lu/%u/%u", r->drift_n, (unsigned long)r->period_us,
+                     (r->ppm_x10 < 0) ? "-" : "", (unsigned long)(abs_ppm / 10), (unsigned long)(abs_ppm % 10),
+                     r->jitter_us, r->drift_outliers);
+    }
+#endif
+#if MONITOR_TC
+    // TC: 热电偶温度/故障位 (故障时温度是上一次的有效值)
+    n += sprintf(msg + n, ", TC:%s%d.%d/%u", (r->tc_deci < 0) ? "-" : "",
+                 abs(r->tc_deci) / 10, abs(r->tc_deci) % 10, r->tc_fault);
+#endif
+#if MONITOR_DEADBAND
+    // SUP: 上次报告之后压掉的窗口数
+    n += sprintf(msg + n, ", SUP:%u", r->suppressed);
+#endif
+    msg[n++] = '\r';
+    msg[n++] = '\n';
+    PROF_END(FORMAT);
+    PROF_BEGIN(REPORT_TX);
+    HAL_UART_Transmit(&huart1, (uint8_t*)msg, (uint16_t)n, 50);
+    PROF_END(REPORT_TX);
+    return (uint16_t)n;
+}
+#else
+// 报告帧 (CMD 0x73，小端)：
+//   标志(1) 实例(1) 相对时间 0.01s(4，有符号) 温度 0.1度(2，有符号) ADC(2)
+//   [帧序号(2)，标志 bit0]
+//   [窗口统计，标志 bit1：ADC、温度各 个数(2) 最小(2) 最大(2) 均值x10(4) 标准差x10(2)]
+//   [压掉的窗口数(2)，标志 bit2]
+//   [延迟 ms(2，有符号) 相关系数%(1，有符号)，标志 bit3]
+//   [预测稳态温度 0.1度(2，有符号) 时间常数 ms(2)，标志 bit4]
+//   [对齐：对数(1) 过期个数(1) ADC 均值x10(2) 温度均值 0.01度(2，有符号)，标志 bit5]
+//   [漂移：拟合帧数(2) 帧周期 us(4) ppm x10(4，有符号) 抖动 us(2) 截断帧数(2)，标志 bit6]
+//   [热电偶：温度 0.1度(2，有符号) 故障位(1)，标志 bit7]
+// 可选字段按标志位顺序追加在末尾
+#define REPORT_HAS_MARK     0x01
+#define REPORT_HAS_STATS    0x02
+#define REPORT_HAS_SUP      0x04
+#define REPORT_HAS_LAG      0x08
+#define REPORT_HAS_PREDICT  0x10
+#define REPORT_HAS_ALIGN    0x20
+#define REPORT_HAS_DRIFT    0x40
+#define REPORT_HAS_TC       0x80
+#define REPORT_FLAGS        ((MONITOR_LATENCY_MARK ? REPORT_HAS_MARK : 0) | (MONITOR_STATS ? REPORT_HAS_STATS : 0) | \
+                             (MONITOR_DEADBAND ? REPORT_HAS_SUP : 0) | (MONITOR_XCORR ? REPORT_HAS_LAG : 0) | \
+                             (MONITOR_PREDICT ? REPORT_HAS_PREDICT : 0) | (MONITOR_ALIGN ? REPORT_HAS_ALIGN : 0) | \
+                             (MONITOR_DRIFT ? REPORT_HAS_DRIFT : 0) | (MONITOR_TC ? REPORT_HAS_TC : 0))
+#define REPORT_PAYLOAD_MAX  80
+
+#if MONITOR_STATS
+static uint8_t *Put_Stats(uint8_t *p, const WinStats_t *s) {
+    p = Put_U16(p, s->n);
+    p = Put_U16(p, (uint16_t)(s->n ? s->min : 0));
+    p = Put_U16(p, (uint16_t)(s->n ? s->max : 0));
+    p = Put_U32(p, (uint32_t)(s->n ? WinStats_Mean10(s) : 0));
+    p = Put_U16(p, (uint16_t)WinStats_Sd10(s));
+    return p;
+}
+#endif
+
+static uint16_t Emit_Report(const MonitorReport_t *r) {
+    uint8_t payload[REPORT_PAYLOAD_MAX];
+    uint8_t *p = payload;
+    PROF_BEGIN(FORMAT);
+    *p++ = REPORT_FLAGS;
+    *p++ = r->sensor;
+    p = Put_U32(p, (uint32_t)r->t_cs);
+    p = Put_U16(p, (uint16_t)r->temp_deci);
+    p = Put_U16(p, (uint16_t)r->adc);
+#if MONITOR_LATENCY_MARK
+    p = Put_U16(p, r->mark);
+#endif
+#if MONITOR_STATS
+    p = Put_Stats(p, &r->adc_stats);
+    p = Put_Stats(p, &r->temp_stats);
+#endif
+#if MONITOR_DEADBAND
+    p = Put_U16(p, r->suppressed);
+#endif
+#if MONITOR_XCORR
+    p = Put_U16(p, (uint16_t)r->lag_ms);
+    *p++ = (uint8_t)r->lag_rho;
+#endif
+#if MONITOR_PREDICT
+    p = Put_U16(p, (uint16_t)r->pred_deci);
+    p = Put_U16(p, r->tau_ms);
+#endif
+#if MONITOR_ALIGN
+    *p++ = r->align.n;
+    *p++ = r->align.stale;
+    p = Put_U16(p, (uint16_t)r->align.adc_x10);
+    p = Put_U16(p, (uint16_t)r->align.temp_centi);
+#endif
+#if MONITOR_DRIFT
+    p = Put_U16(p, r->drift_n);
+    p = Put_U32(p, r->period_us);
+    p = Put_U32(p, (uint32_t)r->ppm_x10);
+    p = Put_U16(p, r->jitter_us);
+    p = Put_U16(p, r->drift_outliers);
+#endif
+#if MONITOR_TC
+    p = Put_U16(p, (uint16_t)r->tc_deci);
+    *p++ = r->tc_fault;
+#endif
+    PROF_END(FORMAT);
+    PROF_BEGIN(REPORT_TX);
+    Monitor_Send_Frame(MONITOR_CMD_REPORT, payload, (uint16_t)(p - payload));
+    PROF_END(REPORT_TX);
+    return (uint16_t)(p - payload) + 5;
+}
+#endif
+
+#if MONITOR_DEADBAND
+// 死区判断：返回 1 表示这个窗口要报告
+static __inline uint8_t Report_Due(const Monitor_t *m, const MonitorReport_t *r, uint32_t now) {
+    int32_t dt = (int32_t)r->temp_deci - m->last_temp_deci;
+    int32_t da = (int32_t)r->adc - (int32_t)m->last_adc;
+    if (!m->reported) return 1;
+    if (dt > MONITOR_DEADBAND_TEMP || dt < -MONITOR_DEADBAND_TEMP) return 1;
+    if (da > MONITOR_DEADBAND_ADC || da < -MONITOR_DEADBAND_ADC) return 1;
+    return (now - m->last_report_tick) >= MONITOR_HEARTBEAT_MS;
+}
+#endif
+
+// 一个实例的 ADC 采样和打印 (主循环调用)
+static void Monitor_Step(Monitor_t *m, uint32_t now) {
+    // 只有在运行且已同步(收到过第一帧)后，才执行ADC和打印
+    if (!(is_running && m->time_synced)) return;
+
+#if MONITOR_ALIGN
+    // --- 2. 新温度帧：把它之前挂起的 ADC 样本插值配对 ---
+    if (m->tf_seq != m->tf_seen) {
+        int16_t temp0, temp1;
+        uint32_t t0, t1;
+        __disable_irq();
+        m->tf_seen = m->tf_seq;
+        temp0 = m->tf_temp[0];
+        temp1 = m->tf_temp[1];
+        t0 = m->tf_tick[0];
+        t1 = m->tf_tick[1];
+        __enable_irq();
+        Align_Frame(&m->align, t0, temp0, t1, temp1);
+    }
+#endif
+
+    // --- 3. ADC 采样 (每50ms) ---
+    if (now >= m->next_adc_tick) {
+        uint32_t val;
+        // 启动一次转换 (超时/没等到 EOC 也计入区段，卡住的那次正是要看的)
+        PROF_BEGIN(ADC_READ);
+        uint8_t ok = Read_ADC(m->cfg, &val);
+        PROF_END(ADC_READ);
+        if (ok) {
+            // 送进窗口
+            Filter_Add(m, val);
+            HIST_ADD(m->index, val);
+#if MONITOR_ALIGN
+            Align_Sample(&m->align, now, (uint16_t)val);
+#endif
+#if MONITOR_STATS
+            WinStats_Add(&m->adc_stats, (int16_t)val);
+#endif
+            TRACE(ADC_SAMPLE, m->adc_count, val);
+        }
+        // 设定下次采样时间
+        m->next_adc_tick += ADC_SAMPLE_MS;
+        if (m->next_adc_tick < now) m->next_adc_tick = now + ADC_SAMPLE_MS;
+    }
+
+    // --- 4. 打印逻辑 (每250ms) ---
+    if (now >= m->next_print_tick) {
+        
+        // a. 获取温度 (原子操作)
+        MonitorReport_t r;
+        uint8_t has_data = 0;
+        __disable_irq();
+        r.temp_deci = m->latest_temp_deci;
+        has_data = m->has_valid_data;
+#if MONITOR_LATENCY_MARK
+        r.mark = m->latest_mark;
+#endif
+#if MONITOR_STATS
+        r.temp_stats = m->temp_stats;
+        WinStats_Reset(&m->temp_stats);
+#endif
+#if MONITOR_PREDICT
+        ThermalModel_t thermal = m->thermal;
+#endif
+#if MONITOR_DRIFT
+        Drift_t drift = m->drift;
+#endif
+        __enable_irq();
+        TRACE(REPORT_BEGIN, has_data, now);
+
+        if (has_data) {
+            // b. 获取ADC滤波值
+            r.sensor = m->index;
+            r.adc = Filter_Result(m);
+#if MONITOR_STATS
+            r.adc_stats = m->adc_stats;
+#endif
+            
+            // c. 计算相对时间 (注意 time_base_tick 已经是 FirstFrameTime + 250ms)
+            // 这样第一次打印时 (now - time_base_tick) ≈ 0，毫秒四舍五入到 0.01s
+            int32_t rel_ms = (int32_t)(now - m->time_base_tick);
+#if MONITOR_DRIFT
+            Drift_Result(&drift, &r.period_us, &r.ppm_x10, &r.jitter_us);
+            r.drift_n = drift.n;
+            r.drift_outliers = drift.outliers;
+#endif
+#if MONITOR_DRIFT_CORRECT
+            rel_ms = Drift_Correct(&drift, rel_ms);
+#endif
+#if MONITOR_TC
+            r.tc_fault = TC_Get(&r.tc_deci);
+#endif
+            r.t_cs = (rel_ms >= 0) ? (rel_ms + 5) / 10 : -((5 - rel_ms) / 10);
+
+#if MONITOR_PREDICT
+            // c1. 稳态预测
+            Thermal_Predict(&thermal, TEMP_MIN_DECI, TEMP_MAX_DECI, &r.pred_deci, &r.tau_ms);
+#endif
+#if MONITOR_XCORR
+            // c2. 互相关延迟 (窗口数 x256 -> 毫秒)
+            {
+                int32_t lag_q8;
+                PROF_BEGIN(XCORR);
+                XCorr_Add(&m->xcorr, (int32_t)r.adc, r.temp_deci);
+                XCorr_Result(&m->xcorr, &lag_q8, &r.lag_rho);
+                PROF_END(XCORR);
+                int32_t lag = lag_q8 * PRINT_INTERVAL_MS;
+                r.lag_ms = (int16_t)((lag >= 0) ? (lag + 128) >> 8 : -((-lag + 128) >> 8));
+            }
+#endif
+            
+            // d. 输出
+#if MONITOR_DEADBAND
+            if (!Report_Due(m, &r, now)) {
+                if (m->suppressed < 0xFFFF) m->suppressed++;
+                TRACE(REPORT_SKIP, m->suppressed, r.adc);
+            } else {
+                r.suppressed = m->suppressed;
+                m->suppressed = 0;
+                m->reported = 1;
+                m->last_temp_deci = r.temp_deci;
+                m->last_adc = r.adc;
+                m->last_report_tick = now;
+#if MONITOR_ALIGN
+                Align_Take(&m->align, &r.align);   // 被压掉的窗口里配好的对留着，累计到这次
+#endif
+                uint16_t sent = Emit_Report(&r);
+                TRACE(REPORT_END, sent, r.adc);
+            }
+#else
+#if MONITOR_ALIGN
+            Align_Take(&m->align, &r.align);
+#endif
+            uint16_t sent = Emit_Report(&r);
+            TRACE(REPORT_END, sent, r.adc);
+#endif
+            
+            // e. 清空ADC缓冲，准备下一个0.25s周期
+            Filter_Reset(m);
+        }
+
+        // f. 设定下次打印
+        m->next_print_tick += PRINT_INTERVAL_MS;
+        if (m->next_print_tick < now) m->next_print_tick = now + PRINT_INTERVAL_MS;
     }
 }
 
 // ================= 核心接口 =================
 
 void Monitor_Init(void) {
-    // 1. 启动串口接收
-    HAL_UART_Receive_IT(&huart1, &rx_byte, 1);
+    // 0. 事件跟踪、性能分析 (同时打开 DWT 周期计数)
+    Trace_Init();
+    Prof_Init();
+
+    // 1. 绑定实例，启动各串口接收
+    for (uint8_t i = 0; i < MONITOR_INSTANCES; i++) {
+        Monitor_t *m = &monitors[i];
+        m->cfg = &monitor_cfg[i];
+        m->index = i;
+        m->p_state = STATE_WAIT_FC;
+#if MONITOR_DRIFT
+        Drift_Reset(&m->drift);
+#endif
+        HAL_UART_Receive_IT(m->cfg->huart, &m->rx_byte, 1);
+#if MONITOR_ACQ == MONITOR_ACQ_REG
+        HAL_ADC_Start(m->cfg->hadc);   // 连续转换一直跑，采样时直接读 DR
+#endif
+    }
     
+#if MONITOR_TC
+    TC_Init();
+#endif
+
     // 2. 初始化时间
     uint32_t now = HAL_GetTick();
     next_led_tick = now + LED_TOGGLE_MS;
+    next_stack_tick = now + STACK_SCAN_MS;
     
     // 3. 提示
     char *msg = "\r\n[System Ready] Waiting for FC 0A 00 01... (1st valid frame triggers 0s start)\r\n";
@@ -138,21 +871,47 @@ void Monitor_Init(void) {
 void Monitor_Task(void) {
     uint32_t now = HAL_GetTick();
 
+    // --- 0. 中断里收到的请求 (导出是阻塞的，不计入 TASK 区段) ---
+    if (g_requests) {
+        uint8_t req;
+        __disable_irq();
+        req = g_requests;
+        g_requests = 0;
+        __enable_irq();
+        if (req & REQ_TRACE_DUMP) Trace_Dump();
+        if (req & REQ_PROF_DUMP) Prof_Dump(req & REQ_PROF_RESET);
+        if (req & REQ_DIAG) Send_Diagnostics();
+        if (req & REQ_HIST_DUMP) Hist_Dump(req & REQ_HIST_RESET);
+        else if (req & REQ_HIST_RESET) Hist_Reset();
+        now = HAL_GetTick();
+    }
+
+    PROF_BEGIN(TASK);
+
     // --- 1. 按键逻辑 (PA3 / BOTTON1) ---
     // 下拉输入，按下为高电平? 
     // 原代码逻辑：if(Read == RESET) ... wait while(Read == RESET)
     // 假设按键按下是低电平(RESET)
-    if (HAL_GPIO_ReadPin(BOTTON1_GPIO_Port, BOTTON1_Pin) == GPIO_PIN_RESET) {
+    if (!IO_READ(BOTTON1)) {
         HAL_Delay(20); 
-        if (HAL_GPIO_ReadPin(BOTTON1_GPIO_Port, BOTTON1_Pin) == GPIO_PIN_RESET) {
-            while(HAL_GPIO_ReadPin(BOTTON1_GPIO_Port, BOTTON1_Pin) == GPIO_PIN_RESET); // 等待松开
+        if (!IO_READ(BOTTON1)) {
+            while(!IO_READ(BOTTON1)); // 等待松开
             
             is_running = !is_running;
+            TRACE(BUTTON, is_running, HAL_GetTick());
             
             if (is_running) {
                 // 重启：清除同步标志，等待新数据重建时间轴
-                time_synced = 0; 
-                adc_count = 0;
+                for (uint8_t i = 0; i < MONITOR_INSTANCES; i++) {
+                    monitors[i].time_synced = 0; 
+                    Filter_Reset(&monitors[i]);
+#if MONITOR_XCORR
+                    XCorr_Reset(&monitors[i].xcorr);
+#endif
+#if MONITOR_ALIGN
+                    Align_Reset(&monitors[i].align);   // 上次运行挂起的样本作废
+#endif
+                }
                 char *s = "-> START\r\n";
                 HAL_UART_Transmit(&huart1, (uint8_t*)s, strlen(s), 50);
             } else {
@@ -164,120 +923,152 @@ void Monitor_Task(void) {
 
     // --- 2. LED 15s 翻转 ---
     if (now >= next_led_tick) {
-        HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);
+        IO_TOGGLE(LED0);   // PC13
         next_led_tick = now + LED_TOGGLE_MS;
     }
     
-    // 只有在运行且已同步(收到过第一帧)后，才执行ADC和打印
-    if (is_running && time_synced) {
-        
-        // --- 3. ADC 采样 (每50ms) ---
-        if (now >= next_adc_tick) {
-            // 启动一次转换
-            HAL_ADC_Start(&hadc1);
-            if (HAL_ADC_PollForConversion(&hadc1, 10) == HAL_OK) {
-                uint32_t val = HAL_ADC_GetValue(&hadc1);
-                
-                // 存入缓冲
-                if (adc_count < MAX_ADC_SAMPLES) {
-                    adc_values[adc_count++] = val;
-                }
+#if MONITOR_TC
+    // --- 2b. 热电偶：每次只走一步 ---
+    TC_Step(now);
+#endif
+
+    // --- 3/4. 各实例 ADC 采样和打印 ---
+    for (uint8_t i = 0; i < MONITOR_INSTANCES; i++) {
+        Monitor_Step(&monitors[i], now);
+    }
+
+    // --- 5. 栈高水位 (每1s，放在最后，不挤占采样和打印) ---
+    if (now >= next_stack_tick) {
+        Stack_Watch_Scan();
+        next_stack_tick = now + STACK_SCAN_MS;
+    }
+    PROF_END(TASK);
+}
+
+// 协议解析：FC | 长度(2B 小端，全长) | CMD | 内容 | XOR
+// 长度不合理或 XOR 错都回到找帧头，帧后多余的 00 在 WAIT_FC 里被跳过
+RAMFUNC void Monitor_Feed_Byte(Monitor_t *m, uint8_t byte) {
+    PROF_BEGIN(PARSE);
+    switch (m->p_state) {
+        case STATE_WAIT_FC:
+            if (byte == MONITOR_FRAME_HEAD) {
+                m->frame_buf[0] = byte;
+                m->p_state = STATE_LEN_L;
             }
-            // 设定下次采样时间
-            next_adc_tick += ADC_SAMPLE_MS;
-            if (next_adc_tick < now) next_adc_tick = now + ADC_SAMPLE_MS;
-        }
+            break;
 
-        // --- 4. 打印逻辑 (每250ms) ---
-        if (now >= next_print_tick) {
-            
-            // a. 获取温度 (原子操作)
-            float current_temp = 0.0f;
-            uint8_t has_data = 0;
-            __disable_irq();
-            current_temp = g_latest_valid_temp;
-            has_data = g_has_valid_data;
-            __enable_irq();
-
-            if (has_data) {
-                // b. 获取ADC中值
-                uint32_t median_adc = Get_Median_ADC();
-                
-                // c. 计算相对时间 (注意 time_base_tick 已经是 FirstFrameTime + 250ms)
-                // 这样第一次打印时 (now - time_base_tick) ≈ 0
-                // 加上 0.005f 是为了四舍五入显示更加友好，防止出现 -0.00
-                float relative_time = (int32_t)(now - time_base_tick) / 1000.0f; 
-                
-                // d. 打印
-                char msg[64];
-                // 格式: [时间s] T:温度 C, ADC:值
-                sprintf(msg, "[%.2fs] T:%.1f C, ADC:%lu\r\n", 
-                        relative_time, current_temp, median_adc);
-                HAL_UART_Transmit(&huart1, (uint8_t*)msg, strlen(msg), 50);
-                
-                // e. 清空ADC缓冲，准备下一个0.25s周期
-                adc_count = 0;
+        case STATE_LEN_L:
+            m->frame_buf[1] = byte;
+            m->frame_len = byte;
+            m->p_state = STATE_LEN_H;
+            break;
+
+        case STATE_LEN_H:
+            m->frame_buf[2] = byte;
+            m->frame_len |= (uint16_t)byte << 8;
+            if (m->frame_len >= 5 && m->frame_len <= RX_FRAME_MAX) {
+                m->frame_idx = 3;
+                m->p_state = STATE_BODY;
+            } else {
+                m->p_state = STATE_WAIT_FC;
             }
+            break;
 
-            // f. 设定下次打印
-            next_print_tick += PRINT_INTERVAL_MS;
-            if (next_print_tick < now) next_print_tick = now + PRINT_INTERVAL_MS;
-        }
+        case STATE_BODY:
+            m->frame_buf[m->frame_idx++] = byte;
+            if (m->frame_idx >= m->frame_len) {
+                uint8_t x = 0;
+                for (uint16_t i = 0; i < m->frame_len - 1; i++) x ^= m->frame_buf[i];
+                if (x == m->frame_buf[m->frame_len - 1]) {
+                    m->rx_frames++;
+                    TRACE(RX_FRAME, m->frame_buf[3], m->frame_len);
+                    Dispatch_Frame(m, m->frame_buf, m->frame_len);
+                } else {
+                    m->rx_bad_xor++;
+                    TRACE(RX_BAD_XOR, m->frame_buf[3], m->frame_len);
+                }
+                m->p_state = STATE_WAIT_FC;
+            }
+            break;
+
+        default:
+            m->p_state = STATE_WAIT_FC;
+            break;
     }
+    PROF_END(PARSE);
 }
 
-// 串口中断回调
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
-    if (huart->Instance == USART1) {
-        HAL_UART_Receive_IT(&huart1, &rx_byte, 1);
-        
-        // FC 0A 00 01 [Byte5 Byte6] ...
-        switch (p_state) {
-            case STATE_WAIT_FC:
-                if (rx_byte == 0xFC) p_state = STATE_CHECK_LEN;
-                break;
-
-            case STATE_CHECK_LEN: // 0A
-                if (rx_byte == 0x0A) p_state = STATE_CHECK_ZERO;
-                else if (rx_byte == 0x05) p_state = STATE_WAIT_FC; // 忽略请求帧
-                else p_state = STATE_WAIT_FC;
-                break;
-
-            case STATE_CHECK_ZERO: // 00
-                if (rx_byte == 0x00) p_state = STATE_CHECK_STATUS;
-                else p_state = STATE_WAIT_FC;
-                break;
-
-            case STATE_CHECK_STATUS: // 01
-                if (rx_byte == 0x01) {
-                    p_state = STATE_READ_DATA;
-                    data_idx = 0;
-                }
-                else p_state = STATE_WAIT_FC;
-                break;
-
-            case STATE_READ_DATA:
-                data_buf[data_idx++] = rx_byte;
-                if (data_idx >= 6) {
-                    // data_buf[0]=LSB, data_buf[1]=MSB
-                    Update_Temperature(data_buf[0], data_buf[1]);
-                    p_state = STATE_WAIT_FC;
-                }
-                break;
-                
-            default:
-                p_state = STATE_WAIT_FC;
-                break;
-        }
+Monitor_t *Monitor_Get(uint8_t index) {
+    return (index < MONITOR_INSTANCES) ? &monitors[index] : 0;
+}
+
+// 按 JRZX 格式发送一帧 (主循环调用，直接写寄存器阻塞发送；9600 波特约 1ms/字节)
+void Monitor_Send_Frame(uint8_t cmd, const uint8_t *payload, uint16_t len) {
+    uint16_t total = len + 5;
+    uint8_t head[4];
+    uint8_t x = 0;
+
+    head[0] = MONITOR_FRAME_HEAD;
+    head[1] = (uint8_t)total;
+    head[2] = (uint8_t)(total >> 8);
+    head[3] = cmd;
+    for (uint8_t i = 0; i < 4; i++) x ^= head[i];
+    for (uint16_t i = 0; i < len; i++) x ^= payload[i];
+
+    Uart_Write(USART1, head, 4);
+    Uart_Write(USART1, payload, len);
+    Uart_Write(USART1, &x, 1);
+}
+
+// 串口中断回调 (与解析、温度更新一起放在 SRAM，见 ramfunc.h)
+RAMFUNC void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+    Monitor_t *m = Find_Monitor(huart);
+    if (m) {
+        PROF_BEGIN(UART_RX_CB);
+        HAL_UART_Receive_IT(huart, &m->rx_byte, 1);
+        Monitor_Feed_Byte(m, m->rx_byte);
+        PROF_END(UART_RX_CB);
     }
 }
 
 // 错误处理
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
-    if (huart->Instance == USART1) {
+    Monitor_t *m = Find_Monitor(huart);
+    if (m) {
+        PROF_BEGIN(UART_ERR_CB);
+        m->uart_errors++;
+        TRACE(UART_ERR, huart->ErrorCode, HAL_GetTick());
         __HAL_UART_CLEAR_OREFLAG(huart);
         __HAL_UART_CLEAR_NEFLAG(huart);
         __HAL_UART_CLEAR_FEFLAG(huart);
-        HAL_UART_Receive_IT(&huart1, &rx_byte, 1);
+        HAL_UART_Receive_IT(huart, &m->rx_byte, 1);
+        PROF_END(UART_ERR_CB);
+    }
+}
+
+#if MONITOR_BENCH
+// ================= 基准测试入口 (只在 ADC_Bench 目标编译) =================
+
+void Monitor_Bench_Reset(void) {
+    g_requests = 0;
+    for (uint8_t i = 0; i < MONITOR_INSTANCES; i++) {
+        Monitor_t *m = &monitors[i];
+        m->cfg = &monitor_cfg[i];
+        m->index = i;
+        m->p_state = STATE_WAIT_FC;
+#if MONITOR_DRIFT
+        Drift_Reset(&m->drift);
+#endif
+        m->has_valid_data = 0;
+        m->time_synced = 0;
+        Filter_Reset(m);
     }
 }
+
+uint32_t Monitor_Bench_Median(const uint32_t *samples, uint8_t n) {
+    Monitor_t *m = &monitors[0];
+    Filter_Reset(m);
+    for (uint8_t i = 0; i < n; i++) Filter_Add(m, samples[i]);
+    return Filter_Result(m);
+}
+#endif
@@ -0,0 +1,90 @@
+/*
+ * align.c
+ * ADC 样本与温度帧的时间对齐
+ * 1. Align_Sample：样本进挂起环；环满时最老的一个直接丢掉，不配对，只记过期 (不计入 n 和平均)。
+ * 2. Align_Frame：所有时刻不晚于最新帧的挂起样本出环，在 [t0, t1] 上插值；
+ *    早于 t0 的 (中间漏了帧) 取 temp0 并记过期。
+ * 3. Align_Take：报告时取平均并清零。
+ * 时间用 HAL_GetTick 毫秒，差值用有符号 32 位，回绕不影响。
+ */
+
+#include "align.h"
+
+// ================= 内部辅助函数 =================
+
+static void Pair(Align_t *a, uint16_t adc, int32_t temp_centi, uint8_t stale) {
+    if (a->n == 0xFF) return;
+    a->n++;
+    a->stale += stale;
+    a->adc_sum += adc;
+    a->temp_sum += temp_centi;
+}
+
+// ================= 核心接口 =================
+
+void Align_Reset(Align_t *a) {
+    a->head = 0;
+    a->count = 0;
+    a->n = 0;
+    a->stale = 0;
+    a->adc_sum = 0;
+    a->temp_sum = 0;
+}
+
+void Align_Sample(Align_t *a, uint32_t tick, uint16_t adc) {
+    if (a->count == ALIGN_PENDING) {
+        // 一直等不到新帧：最老的丢掉，不配对，只记过期
+        a->head = (uint8_t)((a->head + 1) % ALIGN_PENDING);
+        a->count--;
+        if (a->stale != 0xFF) a->stale++;
+    }
+    uint8_t i = (uint8_t)((a->head + a->count) % ALIGN_PENDING);
+    a->tick[i] = tick;
+    a->adc[i] = adc;
+    a->count++;
+}
+
+void Align_Frame(Align_t *a, uint32_t t0, int16_t temp0, uint32_t t1, int16_t temp1) {
+    int32_t span = (int32_t)(t1 - t0);
+    uint8_t gap = span > ALIGN_STALE_MS;
+
+    while (a->count) {
+        uint8_t i = a->head;
+        int32_t dt = (int32_t)(a->tick[i] - t0);
+        if ((int32_t)(a->tick[i] - t1) > 0) break;   // 比最新帧还新，继续等
+
+        int32_t temp;
+        if (dt < 0) {
+            temp = (int32_t)temp0 * 10;
+            Pair(a, a->adc[i], temp, 1);
+        } else {
+            // 0.01度：temp0 + (temp1 - temp0) * dt / span，四舍五入
+            temp = (int32_t)temp0 * 10;
+            if (span > 0) {
+                int32_t num = ((int32_t)temp1 - temp0) * 10 * dt;
+                temp += (num >= 0) ? (num + span / 2) / span : -((-num + span / 2) / span);
+            }
+            Pair(a, a->adc[i], temp, gap);
+        }
+        a->head = (uint8_t)((a->head + 1) % ALIGN_PENDING);
+        a->count--;
+    }
+}
+
+void Align_Take(Align_t *a, AlignResult_t *out) {
+    uint8_t paired = (uint8_t)(a->n);
+    out->n = paired;
+    out->stale = a->stale;
+    if (paired) {
+        out->adc_x10 = (a->adc_sum * 10 + paired / 2) / paired;
+        out->temp_centi = (a->temp_sum >= 0) ? (a->temp_sum + paired / 2) / paired
+                                             : -((-a->temp_sum + paired / 2) / paired);
+    } else {
+        out->adc_x10 = 0;
+        out->temp_centi = 0;
+    }
+    a->n = 0;
+    a->stale = 0;
+    a->adc_sum = 0;
+    a->temp_sum = 0;
+}
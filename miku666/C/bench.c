@@ -0,0 +1,310 @@
+/*
+ * bench.c
+ * 上电基准测试 (ADC_Bench 目标，MONITOR_BENCH=1)
+ * 功能：
+ * 1. 用 DWT 周期计数测：帧解析、ADC 中值、浮点/定点格式化、XOR 校验、ADC 读取两种方式、
+ *    GPIO 读/翻转 (HAL 函数 对比 hw_io.h 寄存器宏)。
+ * 2. 每项重复 BENCH_ITERS 次，每次单独计时 (扣除计时开销)，输出 最小/平均/最大 周期。
+ * 3. 结果一次性打印成机器可读块，上位机 bench_cmp 对比不同固件版本：
+ *      #BENCH_BEGIN version=2 hz=72000000 overhead=6 ramfunc=1 build=...
+ *      case,unit,iters,min,mean,max
+ *      parse_temp_frame,frame,200,....
+ *      #BENCH_END cases=14
+ *    版本变化：
+ *      1 -> 2  新增 gpio_read_hal、gpio_read_reg、gpio_toggle_hal、gpio_toggle_reg (10 项 -> 14 项)；
+ *              adc_reg 改用 hw_io.h 的 ADC_EOC/ADC_VALUE，读的寄存器不变，数值可直接对比。
+ *      1 的后期输出头行多了 ramfunc= 字段 (RAMFUNC 开关)，用例没变，没有加版本号。
+ * 开着中断跑 (SysTick 照常)，偶发的中断只会抬高 max，对比请看 min/mean。
+ * 也可以在 Renode 里跑，见 MDK-ARM/renode/bench_stm32f103.resc。
+ */
+
+#include "bench.h"
+#include "Monitor_usart.h"
+#include "cycles.h"
+#include "ramfunc.h"
+#include "hw_io.h"
+#include "usart.h"
+#include "adc.h"
+#include "stdio.h"
+#include "string.h"
+
+#if MONITOR_BENCH
+
+extern UART_HandleTypeDef huart1;
+extern ADC_HandleTypeDef hadc1;
+
+// ================= 宏定义与配置 =================
+#define BENCH_VERSION       2       // 输出格式或用例变化时加 1
+#define BENCH_ITERS         200
+#define XOR_BYTES           256
+#define NOISE_BYTES         64
+#define ADC_SPIN_MAX        10000   // 寄存器读法等 EOC 的上限 (模拟器里可能没有 ADC 模型)
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t n;
+} BenchStat_t;
+
+// ================= 全局变量 =================
+static uint32_t bench_overhead = 0;
+static volatile uint32_t bench_sink;        // 吃掉结果，防止被优化掉
+static __ALIGNED(4) uint8_t xor_buf[XOR_BYTES];
+static uint8_t noise_buf[NOISE_BYTES];
+static uint8_t case_count = 0;
+
+// 真实抓包里的一帧温度 (28.5度) + 帧后的 00
+static const uint8_t temp_frame[] = {0xFC, 0x0A, 0x00, 0x01, 0x1D, 0x01, 0x1C, 0x01, 0x00, 0xF6, 0x00};
+
+// ================= 内部辅助函数 =================
+
+static uint32_t lcg_state = 12345;
+static uint32_t Lcg_Next(void) {
+    lcg_state = lcg_state * 1103515245u + 12345u;
+    return lcg_state >> 8;
+}
+
+static void Stat_Reset(BenchStat_t *s) {
+    s->min = 0xFFFFFFFFu;
+    s->max = 0;
+    s->total = 0;
+    s->n = 0;
+}
+
+static void Stat_Add(BenchStat_t *s, uint32_t cycles) {
+    cycles = (cycles > bench_overhead) ? cycles - bench_overhead : 0;
+    if (cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+    s->total += cycles;
+    s->n++;
+}
+
+static void Bench_Print_Line(const char *line) {
+    HAL_UART_Transmit(&huart1, (uint8_t*)line, strlen(line), 200);
+}
+
+static void Bench_Report(const char *name, const char *unit, const BenchStat_t *s) {
+    char line[80];
+    uint32_t mean = s->n ? (uint32_t)(s->total / s->n) : 0;
+    sprintf(line, "%s,%s,%lu,%lu,%lu,%lu\r\n", name, unit, (unsigned long)s->n,
+            (unsigned long)(s->n ? s->min : 0), (unsigned long)mean, (unsigned long)s->max);
+    Bench_Print_Line(line);
+    case_count++;
+}
+
+// ================= 测试用例 =================
+
+// 一帧温度 (11 字节) 逐字节喂给解析器
+static void Case_Parse_Temp(void) {
+    BenchStat_t s;
+    Monitor_t *m = Monitor_Get(0);
+    Stat_Reset(&s);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        Monitor_Bench_Reset();
+        uint32_t t0 = CYCLES_NOW();
+        for (uint8_t i = 0; i < sizeof(temp_frame); i++) Monitor_Feed_Byte(m, temp_frame[i]);
+        Stat_Add(&s, CYCLES_NOW() - t0);
+    }
+    Bench_Report("parse_temp_frame", "frame", &s);
+}
+
+// 64 字节随机噪声 (夹杂 0xFC)，测找帧头和拒绝坏帧的开销
+static void Case_Parse_Noise(void) {
+    BenchStat_t s;
+    Monitor_t *m = Monitor_Get(0);
+    Stat_Reset(&s);
+    for (int i = 0; i < NOISE_BYTES; i++) noise_buf[i] = (i % 9 == 0) ? 0xFC : (uint8_t)Lcg_Next();
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        Monitor_Bench_Reset();
+        uint32_t t0 = CYCLES_NOW();
+        for (int i = 0; i < NOISE_BYTES; i++) Monitor_Feed_Byte(m, noise_buf[i]);
+        Stat_Add(&s, CYCLES_NOW() - t0);
+    }
+    Bench_Report("parse_noise_64", "64B", &s);
+}
+
+static void Case_Median(uint8_t n, const char *name) {
+    BenchStat_t s;
+    uint32_t samples[10];
+    Stat_Reset(&s);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        for (uint8_t i = 0; i < n; i++) samples[i] = Lcg_Next() & 0x0FFF;
+        uint32_t t0 = CYCLES_NOW();
+        bench_sink = Monitor_Bench_Median(samples, n);
+        Stat_Add(&s, CYCLES_NOW() - t0);
+    }
+    Bench_Report(name, "call", &s);
+}
+
+// 与报告行相同的格式，浮点 sprintf
+static void Case_Format_Float(void) {
+    BenchStat_t s;
+    char msg[64];
+    Stat_Reset(&s);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        float t = (float)it * 0.25f;
+        float temp = 20.0f + (float)(it % 100) / 10.0f;
+        uint32_t adc = 2000 + (uint32_t)it;
+        uint32_t t0 = CYCLES_NOW();
+        sprintf(msg, "[%.2fs] T:%.1f C, ADC:%lu\r\n", t, temp, (unsigned long)adc);
+        Stat_Add(&s, CYCLES_NOW() - t0);
+        bench_sink = (uint8_t)msg[1];
+    }
+    Bench_Report("format_float", "line", &s);
+}
+
+// 同样的输出，全用整数 (时间 ms、温度 0.1 度)
+static void Case_Format_Fixed(void) {
+    BenchStat_t s;
+    char msg[64];
+    Stat_Reset(&s);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        uint32_t t_ms = (uint32_t)it * 250;
+        int32_t deci = 200 + (it % 100);
+        uint32_t adc = 2000 + (uint32_t)it;
+        uint32_t t0 = CYCLES_NOW();
+        sprintf(msg, "[%lu.%02lus] T:%ld.%ld C, ADC:%lu\r\n", (unsigned long)(t_ms / 1000),
+                (unsigned long)((t_ms % 1000) / 10), (long)(deci / 10), (long)(deci % 10), (unsigned long)adc);
+        Stat_Add(&s, CYCLES_NOW() - t0);
+        bench_sink = (uint8_t)msg[1];
+    }
+    Bench_Report("format_fixed", "line", &s);
+}
+
+// XOR 校验：逐字节
+static void Case_Xor_Byte(void) {
+    BenchStat_t s;
+    Stat_Reset(&s);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        uint32_t t0 = CYCLES_NOW();
+        uint8_t x = 0;
+        for (int i = 0; i < XOR_BYTES; i++) x ^= xor_buf[i];
+        Stat_Add(&s, CYCLES_NOW() - t0);
+        bench_sink = x;
+    }
+    Bench_Report("xor_byte_256", "256B", &s);
+}
+
+// XOR 校验：按 32 位字异或再折叠 (缓冲 4 字节对齐)
+static void Case_Xor_Word(void) {
+    BenchStat_t s;
+    Stat_Reset(&s);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        uint32_t t0 = CYCLES_NOW();
+        const uint32_t *w = (const uint32_t*)xor_buf;
+        uint32_t x = 0;
+        for (int i = 0; i < XOR_BYTES / 4; i++) x ^= w[i];
+        x ^= x >> 16;
+        x ^= x >> 8;
+        Stat_Add(&s, CYCLES_NOW() - t0);
+        bench_sink = x & 0xFF;
+    }
+    Bench_Report("xor_word_256", "256B", &s);
+}
+
+// ADC：Monitor_Task 现在的写法 (HAL 启动 + 轮询 + 取值)
+static void Case_Adc_Hal(void) {
+    BenchStat_t s;
+    Stat_Reset(&s);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        uint32_t t0 = CYCLES_NOW();
+        HAL_ADC_Start(&hadc1);
+        if (HAL_ADC_PollForConversion(&hadc1, 10) == HAL_OK) bench_sink = HAL_ADC_GetValue(&hadc1);
+        Stat_Add(&s, CYCLES_NOW() - t0);
+    }
+    HAL_ADC_Stop(&hadc1);
+    Bench_Report("adc_read_hal", "sample", &s);
+}
+
+// ADC：连续转换已在跑，直接等 EOC 读 DR
+static void Case_Adc_Reg(void) {
+    BenchStat_t s;
+    Stat_Reset(&s);
+    HAL_ADC_Start(&hadc1);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        uint32_t spin = ADC_SPIN_MAX;
+        uint32_t t0 = CYCLES_NOW();
+        while (!ADC_EOC(ADC1) && --spin) {}
+        bench_sink = ADC_VALUE(ADC1);
+        Stat_Add(&s, CYCLES_NOW() - t0);
+    }
+    HAL_ADC_Stop(&hadc1);
+    Bench_Report("adc_read_reg", "sample", &s);
+}
+
+// GPIO：读按键 / 翻转 LED2 (PA2，板上不接东西)，HAL 函数对比寄存器宏
+static void Case_Gpio(void) {
+    BenchStat_t s_read_hal, s_read_reg, s_tog_hal, s_tog_reg;
+    Stat_Reset(&s_read_hal);
+    Stat_Reset(&s_read_reg);
+    Stat_Reset(&s_tog_hal);
+    Stat_Reset(&s_tog_reg);
+    for (int it = 0; it < BENCH_ITERS; it++) {
+        uint32_t t0 = CYCLES_NOW();
+        bench_sink = HAL_GPIO_ReadPin(BOTTON1_GPIO_Port, BOTTON1_Pin);
+        Stat_Add(&s_read_hal, CYCLES_NOW() - t0);
+
+        t0 = CYCLES_NOW();
+        bench_sink = IO_READ(BOTTON1);
+        Stat_Add(&s_read_reg, CYCLES_NOW() - t0);
+
+        t0 = CYCLES_NOW();
+        HAL_GPIO_TogglePin(LED2_GPIO_Port, LED2_Pin);
+        Stat_Add(&s_tog_hal, CYCLES_NOW() - t0);
+
+        t0 = CYCLES_NOW();
+        IO_TOGGLE(LED2);
+        Stat_Add(&s_tog_reg, CYCLES_NOW() - t0);
+    }
+    Bench_Report("gpio_read_hal", "call", &s_read_hal);
+    Bench_Report("gpio_read_reg", "call", &s_read_reg);
+    Bench_Report("gpio_toggle_hal", "call", &s_tog_hal);
+    Bench_Report("gpio_toggle_reg", "call", &s_tog_reg);
+}
+
+// ================= 核心接口 =================
+
+void Bench_Run(void) {
+    char line[96];
+
+    Cycles_Init();
+    // 空计时取最小值作为开销
+    bench_overhead = 0xFFFFFFFFu;
+    for (int i = 0; i < 8; i++) {
+        uint32_t t0 = CYCLES_NOW();
+        uint32_t d = CYCLES_NOW() - t0;
+        if (d < bench_overhead) bench_overhead = d;
+    }
+    for (int i = 0; i < XOR_BYTES; i++) xor_buf[i] = (uint8_t)Lcg_Next();
+
+    sprintf(line, "\r\n#BENCH_BEGIN version=%d hz=%lu overhead=%lu ramfunc=%d build=%s_%s\r\n", BENCH_VERSION,
+            (unsigned long)SystemCoreClock, (unsigned long)bench_overhead, MONITOR_RAMFUNC, __DATE__, __TIME__);
+    Bench_Print_Line(line);
+    Bench_Print_Line("case,unit,iters,min,mean,max\r\n");
+
+    case_count = 0;
+    Case_Parse_Temp();
+    Case_Parse_Noise();
+    Case_Median(5, "median_5");
+    Case_Median(10, "median_10");
+    Case_Format_Float();
+    Case_Format_Fixed();
+    Case_Xor_Byte();
+    Case_Xor_Word();
+    Case_Adc_Hal();
+    Case_Adc_Reg();
+    Case_Gpio();
+
+    sprintf(line, "#BENCH_END cases=%u\r\n", case_count);
+    Bench_Print_Line(line);
+
+    Monitor_Bench_Reset();
+}
+
+#else
+
+void Bench_Run(void) {
+}
+
+#endif /* MONITOR_BENCH */
@@ -0,0 +1,132 @@
+/*
+ * drift.c
+ * 帧时钟漂移估计
+ * 1. 第一帧只记时刻，第二帧给出初始周期；前几帧间隔明显不对时从当前帧重来。
+ * 2. 之后每帧：k = round((到达 - 相位) / 周期)，k = 0 是多出来的帧，跳过；
+ *    预测 = 相位 + k*周期，残差 e 截断到门限内，然后
+ *    相位 += alpha*e，周期 += beta*e/k，alpha = 2(2n-1)/(n(n+1))，beta = 6/(n(n+1))。
+ *    这组增益下递推结果和对全部 n 帧做最小二乘一样；n 封顶后变成固定增益的跟踪器。
+ * 3. 相位相对上一帧时刻保存，Q32 毫秒不会溢出，HAL_GetTick 回绕也不影响。
+ * 4. 增益直接做乘除，不做定点化，n 很大时 beta 也不会被截成 0；
+ *    残差不超过半个周期 (2^49)，乘 2(2n-1) 要求 n 不超过 2048。
+ */
+
+#include "drift.h"
+
+#define Q32_PER_MS      ((int64_t)1 << 32)
+
+// ================= 内部辅助函数 =================
+
+static uint32_t Isqrt32(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static __inline int64_t Q32_To_Us(int64_t q) {
+    return (q >= 0) ? (q * 1000 + Q32_PER_MS / 2) >> 32 : -((-q * 1000 + Q32_PER_MS / 2) >> 32);
+}
+
+static void Restart(Drift_t *d, uint32_t tick) {
+    d->last_tick = tick;
+    d->phase = 0;
+    d->n = 1;
+}
+
+// ================= 核心接口 =================
+
+void Drift_Reset(Drift_t *d) {
+    d->phase = 0;
+    d->period = 0;
+    d->ref = (DRIFT_NOMINAL_US > 0) ? ((int64_t)DRIFT_NOMINAL_US << 32) / 1000 : 0;
+    d->var_us2 = 0;
+    d->n = 0;
+    d->outliers = 0;
+}
+
+void Drift_Add(Drift_t *d, uint32_t tick) {
+    if (d->n == 0) {
+        Restart(d, tick);
+        return;
+    }
+    int64_t y = (int64_t)(tick - d->last_tick) << 32;   // 相对上一帧 (ms Q32)
+    if (d->n == 1) {
+        if (y <= 0) return;
+        d->period = y;
+        d->last_tick = tick;
+        d->n = 2;
+        return;
+    }
+
+    int64_t dt = y - d->phase;
+    int64_t k = (dt + d->period / 2) / d->period;
+    if (k < 1) {
+        if (d->n < 4) Restart(d, tick);                // 起步阶段的周期不可信，重来
+        else if (d->outliers < 0xFFFF) d->outliers++;
+        return;
+    }
+    if (k > DRIFT_MAX_GAP) {
+        // 断流：周期和拟合长度保留，相位对到这一帧
+        d->last_tick = tick;
+        d->phase = 0;
+        return;
+    }
+
+    int64_t e = dt - k * d->period;
+    if (d->n < 4 && (e > d->period / 4 || e < -d->period / 4)) {
+        Restart(d, tick);
+        return;
+    }
+
+    // 截断：门限 = max(下限, 4 倍抖动)
+    int64_t gate = ((int64_t)DRIFT_GATE_MIN_US << 32) / 1000;
+    int64_t g4 = ((int64_t)Isqrt32(d->var_us2) * 4 << 32) / 1000;
+    if (g4 > gate) gate = g4;
+    if (e > gate || e < -gate) {
+        e = (e > 0) ? gate : -gate;
+        if (d->outliers < 0xFFFF) d->outliers++;
+    }
+
+    // 残差方差 (us^2)：上限 65535us 防止平方溢出
+    int64_t e_us = Q32_To_Us(e);
+    if (e_us > 65535) e_us = 65535;
+    if (e_us < -65535) e_us = -65535;
+    uint32_t sq = (uint32_t)(e_us * e_us);
+    d->var_us2 = (d->n == 2) ? sq : d->var_us2 - d->var_us2 / 16 + sq / 16;
+
+    if (d->n < DRIFT_MAX_N) d->n++;
+    int64_t nn = (int64_t)d->n * (d->n + 1);
+    int64_t ph = d->phase + k * d->period + (e * 2 * (2 * d->n - 1)) / nn;
+    d->period += (e * 6) / (nn * k);
+    d->phase = ph - y;                                   // 改成相对这一帧
+    d->last_tick = tick;
+
+    if (d->ref == 0 && d->n >= DRIFT_LOCK_N) d->ref = d->period;
+}
+
+uint8_t Drift_Result(const Drift_t *d, uint32_t *period_us, int32_t *ppm_x10, uint16_t *jitter_us) {
+    uint32_t j = Isqrt32(d->var_us2);
+    *period_us = (d->n >= 2) ? (uint32_t)Q32_To_Us(d->period) : 0;
+    *jitter_us = (j > 0xFFFF) ? 0xFFFF : (uint16_t)j;
+    *ppm_x10 = 0;
+    if (d->n < DRIFT_LOCK_N || d->ref == 0) return 0;
+    *ppm_x10 = (int32_t)(((d->period - d->ref) * 10000000) / d->ref);
+    return 1;
+}
+
+int32_t Drift_Correct(const Drift_t *d, int32_t rel_ms) {
+    if (d->n < DRIFT_LOCK_N || d->ref == 0) return rel_ms;
+    // t_传感器 = t_本机 * ref / period ≈ t_本机 * (1 - ppm)，ppm 的平方项可以忽略
+    int64_t ppm_x10 = ((d->period - d->ref) * 10000000) / d->ref;
+    return (int32_t)(rel_ms - ((int64_t)rel_ms * ppm_x10) / 10000000);
+}
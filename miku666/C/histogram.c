@@ -0,0 +1,71 @@
+/*
+ * histogram.c
+ * ADC 直方图导出
+ * 导出格式 (每帧一块，CMD 0x74，多字节均为小端)：
+ *   块号(1) 总块数(1) 实例(1) 箱宽位数(1) 起始箱号(2) + 计数(2) x N
+ *   每块最多 64 箱，实例 0 的各块在前；总块数为 0 表示固件编译时没打开 MONITOR_HIST。
+ * 9600 波特下每块 (约 140 字节) 发送约 0.15s，256 箱一个实例约 0.6s。
+ */
+
+#include "histogram.h"
+
+#define HIST_HDR_BYTES      6
+#define HIST_PER_FRAME      64
+#define HIST_CHUNKS         ((HIST_BINS + HIST_PER_FRAME - 1) / HIST_PER_FRAME)
+
+#if MONITOR_HIST
+
+// ================= 全局变量 =================
+uint16_t g_hist[MONITOR_INSTANCES][HIST_BINS];
+
+#endif
+
+// ================= 内部辅助函数 =================
+
+static uint8_t *Put_U16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+// ================= 核心接口 =================
+
+void Hist_Reset(void) {
+#if MONITOR_HIST
+    for (int i = 0; i < MONITOR_INSTANCES; i++) {
+        for (int b = 0; b < HIST_BINS; b++) g_hist[i][b] = 0;
+    }
+#endif
+}
+
+void Hist_Dump(uint8_t reset) {
+    uint8_t payload[HIST_HDR_BYTES + HIST_PER_FRAME * 2];
+#if MONITOR_HIST
+    uint8_t chunks = (uint8_t)(HIST_CHUNKS * MONITOR_INSTANCES);
+    uint8_t c = 0;
+
+    for (uint8_t inst = 0; inst < MONITOR_INSTANCES; inst++) {
+        for (uint16_t first = 0; first < HIST_BINS; first += HIST_PER_FRAME) {
+            uint16_t n = (HIST_BINS - first < HIST_PER_FRAME) ? HIST_BINS - first : HIST_PER_FRAME;
+            uint8_t *p = payload;
+            *p++ = c++;
+            *p++ = chunks;
+            *p++ = inst;
+            *p++ = HIST_BIN_SHIFT;
+            p = Put_U16(p, first);
+            for (uint16_t b = 0; b < n; b++) p = Put_U16(p, g_hist[inst][first + b]);
+            Monitor_Send_Frame(MONITOR_CMD_HIST, payload, (uint16_t)(p - payload));
+        }
+    }
+    if (reset) Hist_Reset();
+#else
+    uint8_t *p = payload;
+    (void)reset;
+    *p++ = 0;
+    *p++ = 0;
+    *p++ = 0;
+    *p++ = HIST_BIN_SHIFT;
+    p = Put_U16(p, 0);
+    Monitor_Send_Frame(MONITOR_CMD_HIST, payload, (uint16_t)(p - payload));
+#endif
+}
@@ -0,0 +1,91 @@
+/*
+ * profile.c
+ * 性能分析表与导出
+ * 导出格式 (一帧，CMD 0x71，多字节均为小端)：
+ *   内核时钟Hz(4) 计时开销(4) 区段数(1) + 区段 x N
+ *   区段 = 次数(4) 最小(4) 最大(4) 总周期(8)，顺序同 profile_zones.def
+ * 区段数为 0 表示固件编译时没打开 MONITOR_PROFILE。
+ */
+
+#include "profile.h"
+#include "Monitor_usart.h"
+
+#define PROF_HDR_BYTES      9
+#define PROF_ZONE_BYTES     20
+
+#if MONITOR_PROFILE
+
+// ================= 全局变量 =================
+ProfStat_t g_prof[PZ_COUNT];
+uint32_t g_prof_overhead = 0;
+
+#endif
+
+// ================= 内部辅助函数 =================
+
+static uint8_t *Put_U32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+// ================= 核心接口 =================
+
+void Prof_Reset(void) {
+#if MONITOR_PROFILE
+    __disable_irq();
+    for (int i = 0; i < PZ_COUNT; i++) {
+        g_prof[i].count = 0;
+        g_prof[i].min = 0xFFFFFFFFu;
+        g_prof[i].max = 0;
+        g_prof[i].total = 0;
+    }
+    __enable_irq();
+#endif
+}
+
+void Prof_Init(void) {
+#if MONITOR_PROFILE
+    Cycles_Init();
+    // 空区段取最小值作为计时开销 (读 CYCCNT 两次 + 减法)
+    uint32_t best = 0xFFFFFFFFu;
+    for (int i = 0; i < 8; i++) {
+        uint32_t t0 = CYCLES_NOW();
+        uint32_t d = CYCLES_NOW() - t0;
+        if (d < best) best = d;
+    }
+    g_prof_overhead = best;
+#endif
+    Prof_Reset();
+}
+
+void Prof_Dump(uint8_t reset) {
+    uint8_t payload[PROF_HDR_BYTES + PZ_COUNT * PROF_ZONE_BYTES];
+    uint8_t *p = payload;
+
+    p = Put_U32(p, SystemCoreClock);
+#if MONITOR_PROFILE
+    ProfStat_t snap[PZ_COUNT];
+    __disable_irq();
+    for (int i = 0; i < PZ_COUNT; i++) snap[i] = g_prof[i];
+    __enable_irq();
+    if (reset) Prof_Reset();
+
+    p = Put_U32(p, g_prof_overhead);
+    *p++ = (uint8_t)PZ_COUNT;
+    for (int i = 0; i < PZ_COUNT; i++) {
+        p = Put_U32(p, snap[i].count);
+        p = Put_U32(p, snap[i].count ? snap[i].min : 0);
+        p = Put_U32(p, snap[i].max);
+        p = Put_U32(p, (uint32_t)snap[i].total);
+        p = Put_U32(p, (uint32_t)(snap[i].total >> 32));
+    }
+#else
+    (void)reset;
+    p = Put_U32(p, 0);
+    *p++ = 0;
+#endif
+    Monitor_Send_Frame(MONITOR_CMD_PROFILE, payload, (uint16_t)(p - payload));
+}
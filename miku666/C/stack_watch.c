@@ -0,0 +1,40 @@
+/*
+ * stack_watch.c
+ * 栈高水位扫描
+ * 栈从 __initial_sp 向下长，最深处以下的字从没被写过，仍是涂色值。
+ * 从栈底 (Stack_Mem) 往上找第一个被改写的字，之上的都算用过。
+ * 局部数组没写满的部分会被当成没用过，所以结果是下限，留余量时按 1~2 个字考虑。
+ */
+
+#include "stack_watch.h"
+
+// 启动文件导出的符号 (MicroLIB 工程会导出 __initial_sp)
+extern uint32_t Stack_Mem[];
+extern uint32_t __initial_sp[];
+
+// ================= 全局变量 =================
+static uint16_t free_words = 0xFFFF;   // 扫描到的最少剩余字数，只减不增
+
+// ================= 核心接口 =================
+
+void Stack_Watch_Scan(void) {
+    const uint32_t *p = Stack_Mem;
+    const uint32_t *top = __initial_sp;
+    uint16_t n = 0;
+
+    // 已知剩余 free_words 个字，之上不用再看
+    while (p < top && n < free_words && *p == STACK_PAINT) {
+        p++;
+        n++;
+    }
+    free_words = n;
+}
+
+uint16_t Stack_Watch_Size(void) {
+    return (uint16_t)((__initial_sp - Stack_Mem) * sizeof(uint32_t));
+}
+
+uint16_t Stack_Watch_Peak(void) {
+    if (free_words == 0xFFFF) Stack_Watch_Scan();
+    return (uint16_t)(Stack_Watch_Size() - free_words * 4u);
+}
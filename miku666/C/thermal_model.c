@@ -0,0 +1,76 @@
+/*
+ * thermal_model.c
+ * 一阶滞后模型辨识与稳态预测
+ * 1. 只用阶跃过程中的帧辨识：上一增量不到 THERMAL_MIN_STEP 的帧跳过，稳态时模型保持不变。
+ * 2. r = Σ d[k]*d[k-1] / Σ d[k-1]^2，遗忘因子 31/32，只看最近几十帧的阶跃。
+ * 3. tau = -帧周期/ln(r)，用 (1+r)/(2(1-r)) 近似 -1/ln(r) (r 接近 1 时误差很小)。
+ * 4. 预测 = 当前温度 + d*r/(1-r)；r 限在 0.985 以内，外推最多放大约 65 倍。
+ */
+
+#include "thermal_model.h"
+
+#define R_ONE       (1L << THERMAL_R_Q)
+#define R_MAX       (R_ONE - R_ONE / 64)     // 0.985
+#define GAP_MS      5000                      // 两帧间隔超过它当断流，不更新帧周期
+
+// ================= 核心接口 =================
+
+void Thermal_Reset(ThermalModel_t *t) {
+    t->last_diff = 0;
+    t->period_ms = 0;
+    t->frames = 0;
+    t->sxy = 0;
+    t->sxx = 0;
+}
+
+void Thermal_Add(ThermalModel_t *t, int16_t temp_deci, uint32_t tick) {
+    if (t->frames == 0) {
+        t->last_temp = temp_deci;
+        t->last_tick = tick;
+        t->frames = 1;
+        return;
+    }
+
+    // 帧周期：1/8 平滑
+    uint32_t dt = tick - t->last_tick;
+    if (dt > 0 && dt < GAP_MS) {
+        if (t->period_ms == 0) t->period_ms = (uint16_t)dt;
+        else t->period_ms = (uint16_t)((int32_t)t->period_ms + ((int32_t)dt - (int32_t)t->period_ms) / 8);
+    }
+
+    int32_t d = (int32_t)temp_deci - t->last_temp;
+    int32_t p = t->last_diff;
+    if (t->frames >= 2 && (p >= THERMAL_MIN_STEP || p <= -THERMAL_MIN_STEP)) {
+        t->sxy -= t->sxy >> THERMAL_FORGET;
+        t->sxx -= t->sxx >> THERMAL_FORGET;
+        t->sxy += d * p * 16;
+        t->sxx += p * p * 16;
+    }
+    t->last_diff = (int16_t)d;
+    t->last_temp = temp_deci;
+    t->last_tick = tick;
+    t->frames = 2;
+}
+
+void Thermal_Predict(const ThermalModel_t *t, int16_t lo, int16_t hi, int16_t *pred_deci, uint16_t *tau_ms) {
+    int32_t pred = t->last_temp;
+    *tau_ms = 0;
+
+    // 至少要有一次像样的阶跃 (两次 MIN_STEP 的增量)
+    if (t->frames >= 2 && t->sxy > 0 && t->sxx >= 2 * 16 * THERMAL_MIN_STEP * THERMAL_MIN_STEP) {
+        int32_t r = (int32_t)(((int64_t)t->sxy << THERMAL_R_Q) / t->sxx);
+        if (r > R_MAX) r = R_MAX;
+
+        uint32_t tau = ((uint32_t)t->period_ms * (uint32_t)(R_ONE + r)) / (uint32_t)(2 * (R_ONE - r));
+        *tau_ms = (tau > 0xFFFF) ? 0xFFFF : (uint16_t)tau;
+
+        int32_t d = t->last_diff;
+        if (d >= THERMAL_MIN_STEP || d <= -THERMAL_MIN_STEP) {
+            pred += (d * r) / (R_ONE - r);
+        }
+    }
+
+    if (pred < lo) pred = lo;
+    if (pred > hi) pred = hi;
+    *pred_deci = (int16_t)pred;
+}
@@ -0,0 +1,126 @@
+/*
+ * thermocouple.c
+ * 热电偶读取状态机
+ * 1. IDLE：到时间了拉低 CS (停止转换，芯片把最高位放到 SO 上)。
+ * 2. SAMPLE：读 SO 一位；读满就拉高 CS (开始下一次转换) 并解码，否则拉高 SCK。
+ * 3. FALL：拉低 SCK，芯片在下降沿送出下一位，下次调用再读。
+ * 主循环两次调用之间至少几微秒，远长于芯片要求的 100ns 建立/脉宽时间，不用另外延时。
+ * 芯片按 CPOL=0 读，SCK 空闲为低。
+ */
+
+#include "thermocouple.h"
+#include "trace.h"
+#include "hw_io.h"
+
+#if TC_CHIP == TC_CHIP_MAX31855
+#define TC_BITS     32
+#else
+#define TC_BITS     16
+#endif
+
+typedef enum {
+    TC_IDLE = 0,
+    TC_SAMPLE,
+    TC_FALL
+} TcState_t;
+
+#if MONITOR_TC
+
+// ================= 全局变量 =================
+static TcState_t tc_state;
+static uint8_t   tc_bits;           // 已读位数
+static uint32_t  tc_shift;
+static uint32_t  tc_next_tick;      // 下次拉低 CS 的时刻
+static int16_t   tc_temp_deci;
+static uint8_t   tc_fault = TC_FAULT_NONE;
+
+// ================= 内部辅助函数 =================
+
+// 0.25度计数 -> 0.1度，四舍五入 (对称)
+static int16_t Quarter_To_Deci(int32_t q) {
+    int32_t v = q * 5;
+    return (int16_t)((v >= 0) ? (v + 1) / 2 : -((-v + 1) / 2));
+}
+
+static void Decode(uint32_t raw) {
+#if TC_CHIP == TC_CHIP_MAX31855
+    // D31~D18 热电偶温度 (有符号)，D16 故障，D2~D0 故障类型
+    if (raw & 0x00010000UL) {
+        tc_fault = (uint8_t)(raw & 0x07);
+        if (!tc_fault) tc_fault = TC_FAULT_OPEN;
+    } else {
+        tc_fault = 0;
+        tc_temp_deci = Quarter_To_Deci((int32_t)raw >> 18);
+    }
+#else
+    // D14~D3 温度，D2 开路
+    tc_fault = (raw & 0x0004) ? TC_FAULT_OPEN : 0;
+    if (!tc_fault) tc_temp_deci = Quarter_To_Deci((int32_t)((raw >> 3) & 0x0FFF));
+#endif
+    TRACE(TC_READ, tc_temp_deci, tc_fault);
+}
+
+#endif /* MONITOR_TC */
+
+// ================= 核心接口 =================
+
+void TC_Init(void) {
+#if MONITOR_TC
+    GPIO_InitTypeDef init = {0};
+    IO_HIGH(Monitor_CS);
+    IO_LOW(Monitor_SCK);
+    init.Pin = Monitor_CS_Pin | Monitor_SCK_Pin;
+    init.Mode = GPIO_MODE_OUTPUT_PP;
+    init.Pull = GPIO_NOPULL;
+    init.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(Monitor_CS_GPIO_Port, &init);   // SO 保持上拉输入
+
+    tc_state = TC_IDLE;
+    tc_next_tick = HAL_GetTick() + TC_PERIOD_MS;   // 上电先让芯片完成一次转换
+#endif
+}
+
+void TC_Step(uint32_t now) {
+#if MONITOR_TC
+    switch (tc_state) {
+        case TC_IDLE:
+            if ((int32_t)(now - tc_next_tick) < 0) return;
+            tc_shift = 0;
+            tc_bits = 0;
+            IO_LOW(Monitor_CS);
+            tc_state = TC_SAMPLE;
+            break;
+
+        case TC_SAMPLE:
+            tc_shift = (tc_shift << 1) | IO_READ(Monitor_SO);
+            if (++tc_bits < TC_BITS) {
+                IO_HIGH(Monitor_SCK);
+                tc_state = TC_FALL;
+            } else {
+                IO_HIGH(Monitor_CS);
+                tc_next_tick = now + TC_PERIOD_MS;
+                tc_state = TC_IDLE;
+                Decode(tc_shift);
+            }
+            break;
+
+        case TC_FALL:
+        default:
+            IO_LOW(Monitor_SCK);
+            tc_state = TC_SAMPLE;
+            break;
+    }
+#else
+    (void)now;
+#endif
+}
+
+uint8_t TC_Get(int16_t *temp_deci) {
+#if MONITOR_TC
+    *temp_deci = tc_temp_deci;
+    return tc_fault;
+#else
+    *temp_deci = 0;
+    return TC_FAULT_NONE;
+#endif
+}
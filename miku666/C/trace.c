@@ -0,0 +1,90 @@
+/*
+ * trace.c
+ * 事件跟踪缓冲与导出
+ * 导出格式 (每帧一块，CMD 0x70，多字节均为小端)：
+ *   块号(1) 总块数(1) 内核时钟Hz(4) 累计写入条数(4) + 事件 x N
+ *   事件 = 时间戳(4) 事件号(2) 参数0(2) 参数1(4)，从最旧到最新
+ * 9600 波特下每块 (16 条，约 200 字节) 发送约 0.2s，整个缓冲约 1.7s，期间不记录新事件。
+ */
+
+#include "trace.h"
+#include "Monitor_usart.h"
+
+#define TRACE_EVT_BYTES     12
+#define TRACE_HDR_BYTES     10
+#define TRACE_PER_FRAME     16
+
+#if MONITOR_TRACE
+
+// ================= 全局变量 =================
+TraceEvent_t g_trace_ring[TRACE_DEPTH];
+volatile uint32_t g_trace_head = 0;
+volatile uint8_t g_trace_on = 0;
+
+// ================= 内部辅助函数 =================
+
+static uint8_t *Put_U16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *Put_U32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+// ================= 核心接口 =================
+
+void Trace_Init(void) {
+    Cycles_Init();
+    g_trace_head = 0;
+    g_trace_on = 1;
+}
+
+void Trace_Dump(void) {
+    uint8_t payload[TRACE_HDR_BYTES + TRACE_PER_FRAME * TRACE_EVT_BYTES];
+
+    g_trace_on = 0;   // 冻结：之后中断里的 TRACE() 直接返回
+
+    uint32_t head = g_trace_head;
+    uint32_t count = (head < TRACE_DEPTH) ? head : TRACE_DEPTH;
+    uint32_t first = head - count;
+    uint8_t chunks = (uint8_t)((count + TRACE_PER_FRAME - 1) / TRACE_PER_FRAME);
+    if (chunks == 0) chunks = 1;   // 空缓冲也发一帧头，上位机知道导出过
+
+    for (uint8_t c = 0; c < chunks; c++) {
+        uint8_t *p = payload;
+        *p++ = c;
+        *p++ = chunks;
+        p = Put_U32(p, SystemCoreClock);
+        p = Put_U32(p, head);
+
+        for (uint32_t k = 0; k < TRACE_PER_FRAME; k++) {
+            uint32_t i = (uint32_t)c * TRACE_PER_FRAME + k;
+            if (i >= count) break;
+            const TraceEvent_t *e = &g_trace_ring[(first + i) & (TRACE_DEPTH - 1)];
+            p = Put_U32(p, e->ts);
+            p = Put_U16(p, e->id);
+            p = Put_U16(p, e->a0);
+            p = Put_U32(p, e->a1);
+        }
+        Monitor_Send_Frame(MONITOR_CMD_TRACE, payload, (uint16_t)(p - payload));
+    }
+
+    g_trace_on = 1;
+    TRACE(TRACE_DUMP, count, head);
+}
+
+#else
+
+void Trace_Init(void) {
+}
+
+void Trace_Dump(void) {
+}
+
+#endif /* MONITOR_TRACE */
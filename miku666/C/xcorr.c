@@ -0,0 +1,124 @@
+/*
+ * xcorr.c
+ * 互相关延迟估计
+ * 1. 两路都先做一阶差分：慢漂移和直流分量都去掉了，阶跃变成一个尖峰，峰位置就是延迟。
+ * 2. sxy[d] = Σ dy[t]*dx[t+d]，t 和 t+d 都在环内。新一对进环时只加含它的项，
+ *    最老一对出环时只减含它的项，每个延迟各一次乘加。
+ * 3. 取结果时按重叠个数归一化，找绝对值最大的延迟，再用左右两点抛物线插值到窗口的 1/256。
+ *    相关系数的分母用整环能量近似 (每个延迟的重叠段能量差别不大)。
+ */
+
+#include "xcorr.h"
+
+#define RING_MASK   (XCORR_LEN - 1)
+
+// ================= 内部辅助函数 =================
+
+static int16_t Clamp16(int32_t v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+static uint32_t Isqrt64(uint64_t v) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+// ================= 核心接口 =================
+
+void XCorr_Reset(XCorr_t *c) {
+    for (int d = 0; d < XCORR_LAGS; d++) c->sxy[d] = 0;
+    c->exx = 0;
+    c->eyy = 0;
+    c->seq = 0;
+    c->primed = 0;
+}
+
+void XCorr_Add(XCorr_t *c, int32_t adc, int16_t temp_deci) {
+    if (!c->primed) {
+        c->prev_x = adc;
+        c->prev_y = temp_deci;
+        c->primed = 1;
+        return;
+    }
+    int16_t x = Clamp16(adc - c->prev_x);
+    int16_t y = Clamp16((int32_t)temp_deci - c->prev_y);
+    c->prev_x = adc;
+    c->prev_y = temp_deci;
+
+    uint32_t t = c->seq;
+    int32_t *s = &c->sxy[XCORR_MAX_LAG];   // s[d]，d = -MAX_LAG..MAX_LAG
+
+    // 1. 最老的一对 (t - LEN) 出环
+    if (t >= XCORR_LEN) {
+        uint32_t o = t - XCORR_LEN;
+        int32_t ox = c->dx[o & RING_MASK], oy = c->dy[o & RING_MASK];
+        for (int d = 0; d <= XCORR_MAX_LAG; d++) s[d] -= oy * c->dx[(o + d) & RING_MASK];
+        for (int d = 1; d <= XCORR_MAX_LAG; d++) s[-d] -= c->dy[(o + d) & RING_MASK] * ox;
+        c->exx -= (uint32_t)(ox * ox);
+        c->eyy -= (uint32_t)(oy * oy);
+    }
+
+    // 2. 新的一对进环
+    c->dx[t & RING_MASK] = x;
+    c->dy[t & RING_MASK] = y;
+    uint32_t avail = (t < XCORR_LEN - 1) ? t : XCORR_LEN - 1;   // 环里比它早的个数
+    int lim = (avail < XCORR_MAX_LAG) ? (int)avail : XCORR_MAX_LAG;
+    for (int d = 0; d <= lim; d++) s[d] += c->dy[(t - d) & RING_MASK] * x;
+    for (int d = 1; d <= lim; d++) s[-d] += y * c->dx[(t - d) & RING_MASK];
+    c->exx += (uint32_t)(x * x);
+    c->eyy += (uint32_t)(y * y);
+    c->seq = t + 1;
+}
+
+void XCorr_Result(const XCorr_t *c, int32_t *lag_q8, int8_t *rho_pct) {
+    uint32_t count = (c->seq < XCORR_LEN) ? c->seq : XCORR_LEN;
+    *lag_q8 = 0;
+    *rho_pct = 0;
+    if (count <= XCORR_MAX_LAG + 1 || c->exx == 0 || c->eyy == 0) return;
+
+    // 每个延迟的平均乘积 x256
+    int32_t v[XCORR_LAGS];
+    int best = 0;
+    for (int i = 0; i < XCORR_LAGS; i++) {
+        int d = i - XCORR_MAX_LAG;
+        uint32_t n = count - (uint32_t)(d < 0 ? -d : d);
+        v[i] = (int32_t)(((int64_t)c->sxy[i] * 256) / (int32_t)n);
+        if ((v[i] < 0 ? -v[i] : v[i]) > (v[best] < 0 ? -v[best] : v[best])) best = i;
+    }
+    if (v[best] == 0) return;
+
+    // 抛物线插值：峰值按同号比较
+    int32_t lag = (best - XCORR_MAX_LAG) * 256;
+    if (best > 0 && best < XCORR_LAGS - 1) {
+        int64_t sgn = (v[best] < 0) ? -1 : 1;
+        int64_t a = sgn * v[best - 1], b = sgn * v[best], cc = sgn * v[best + 1];
+        int64_t den = a - 2 * b + cc;
+        if (den < 0) {
+            int64_t off = ((a - cc) * 128) / den;
+            if (off > 128) off = 128;
+            if (off < -128) off = -128;
+            lag += (int32_t)off;
+        }
+    }
+    *lag_q8 = lag;
+
+    // 相关系数 = 平均乘积 / sqrt(平均 dx^2 * 平均 dy^2)
+    uint32_t norm = Isqrt64((uint64_t)c->exx * c->eyy);
+    int64_t rho = ((int64_t)v[best] * 100 * (int64_t)count) / ((int64_t)norm * 256);
+    if (rho > 100) rho = 100;
+    if (rho < -100) rho = -100;
+    *rho_pct = (int8_t)rho;
+}
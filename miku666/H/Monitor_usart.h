@@ -6,8 +6,38 @@
 
 #include "main.h"
 
+// 基准测试目标 (ADC_Bench) 在工程里定义 MONITOR_BENCH=1
+#ifndef MONITOR_BENCH
+#define MONITOR_BENCH 0
+#endif
+
+// JRZX 协议：FC | 长度(2B 小端，全长) | CMD | 内容 | XOR
+#define MONITOR_FRAME_HEAD  0xFC
+#define MONITOR_CMD_TEMP    0x01  // 温度转换上传
+#define MONITOR_CMD_TRACE   0x70  // 私有：导出事件跟踪 (见 trace.h)
+#define MONITOR_CMD_PROFILE 0x71  // 私有：返回性能分析表 (见 profile.h)，内容 01 表示返回后清零
+#define MONITOR_CMD_DIAG    0x72  // 私有：返回诊断信息 (栈高水位、收帧计数等)
+#define MONITOR_CMD_REPORT  0x73  // 私有：二进制报告 (MONITOR_FORMAT_FRAME 时代替文本行，见 monitor_pipeline.h)
+#define MONITOR_CMD_HIST    0x74  // 私有：返回 ADC 直方图 (见 histogram.h)，内容 01 返回后清零，02 只清零
+
+// 传感器实例数 (每个实例 = 一个传感器串口 + 一路 ADC 通道，配对表在 Monitor_usart.c)
+#ifndef MONITOR_INSTANCES
+#define MONITOR_INSTANCES 1
+#endif
+
+typedef struct Monitor_s Monitor_t;
+
 // 功能函数声明
 void Monitor_Init(void);   // 初始化
 void Monitor_Task(void);   // 在主循环中调用，用于ADC定时采样
+Monitor_t *Monitor_Get(uint8_t index);              // 第 index 个实例，越界返回 0
+void Monitor_Feed_Byte(Monitor_t *m, uint8_t byte); // 协议解析，逐字节输入 (串口中断里调用)
+void Monitor_Send_Frame(uint8_t cmd, const uint8_t *payload, uint16_t len);   // 按 JRZX 格式发送一帧 (阻塞)
+
+#if MONITOR_BENCH
+// 基准测试直接调用的内部函数 (见 bench.c)
+void Monitor_Bench_Reset(void);                                      // 解析器与时间轴回到上电状态
+uint32_t Monitor_Bench_Median(const uint32_t *samples, uint8_t n);   // 装入 n 个样本后取中值
+#endif
 
 #endif /* MONITOR_USART_H */
@@ -0,0 +1,47 @@
+/*
+ * align.h
+ * 温度对齐到 ADC 采样时刻：ADC 样本先带时间戳挂起，等到比它新的温度帧到了，
+ * 用夹住它的前后两帧线性插值出该时刻的温度，配成一对。报告取上次报告以来配好的各对的平均
+ * (死区压掉的窗口不取，累计到下一次真正发出的报告；最多 255 对，之后的不再计入)。
+ * 这样每对 (ADC, 温度) 在时间上是对齐的，代价是比原始报告晚约一个温度帧周期。
+ * 两帧间隔超过 ALIGN_STALE_MS，或样本等不到新帧被挤出，记为过期。全整数。
+ */
+#ifndef ALIGN_H
+#define ALIGN_H
+
+#include "main.h"
+
+#ifndef ALIGN_PENDING
+#define ALIGN_PENDING   16      // 挂起样本数 (50ms 采样时 0.8s，温度帧约 0.27s 一帧)
+#endif
+
+#ifndef ALIGN_STALE_MS
+#define ALIGN_STALE_MS  600     // 前后两帧间隔超过它 (丢了帧)，插值结果标为过期
+#endif
+
+typedef struct {
+    uint32_t tick[ALIGN_PENDING];
+    uint16_t adc[ALIGN_PENDING];
+    uint8_t  head;              // 最老的挂起样本
+    uint8_t  count;
+    // 上次取走以来配好的
+    uint8_t  n;
+    uint8_t  stale;             // 过期的个数 (含等不到新帧被挤出环的，它们不计入 n)
+    uint32_t adc_sum;
+    int32_t  temp_sum;          // 0.01度
+} Align_t;
+
+typedef struct {
+    uint8_t  n;                 // 配好的对数，0 表示这段时间没有
+    uint8_t  stale;             // 过期的个数
+    uint32_t adc_x10;           // ADC 平均 x10
+    int32_t  temp_centi;        // 温度平均 (0.01度)
+} AlignResult_t;
+
+void Align_Reset(Align_t *a);
+void Align_Sample(Align_t *a, uint32_t tick, uint16_t adc);
+// 新温度帧：t1/temp1 是最新一帧，t0/temp0 是前一帧 (没有前一帧时传同一帧)
+void Align_Frame(Align_t *a, uint32_t t0, int16_t temp0, uint32_t t1, int16_t temp1);
+void Align_Take(Align_t *a, AlignResult_t *out);
+
+#endif /* ALIGN_H */
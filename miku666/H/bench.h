@@ -0,0 +1,12 @@
+/*
+ * bench.h
+ * 上电基准测试 (只在 ADC_Bench 目标里有内容)
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "main.h"
+
+void Bench_Run(void);   // 跑完整套测试，结果以 #BENCH_BEGIN ... #BENCH_END 块打印到 USART1
+
+#endif /* BENCH_H */
@@ -0,0 +1,19 @@
+/*
+ * cycles.h
+ * DWT 周期计数器 (72MHz 下约 59.6s 回绕一次，差值用无符号减法即可)
+ */
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include "main.h"
+
+// 打开 DWT->CYCCNT (不接调试器也能用)
+static __inline void Cycles_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+#define CYCLES_NOW()   (DWT->CYCCNT)
+
+#endif /* CYCLES_H */
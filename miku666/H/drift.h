@@ -0,0 +1,40 @@
+/*
+ * drift.h
+ * 传感器帧时钟相对本机 HAL_GetTick 的漂移估计：对 (帧号, 到达时刻) 做直线拟合，
+ * 斜率就是用本机毫秒量出来的帧周期，和标称周期一比得到 ppm。
+ * 传感器帧里没有序号，帧号按到达间隔除以当前周期四舍五入推出来 (丢帧时跳号，多出来的帧跳过)。
+ * 拟合是递推的 (扩展记忆的 alpha-beta，前 DRIFT_MAX_N 帧与最小二乘等价，之后固定增益跟踪慢变化)，
+ * 残差超过门限的按门限截断 (Huber)，状态大小固定。Drift_Add 在收到温度帧时调用 (中断里)。
+ */
+#ifndef DRIFT_H
+#define DRIFT_H
+
+#include "main.h"
+
+#ifndef DRIFT_NOMINAL_US
+#define DRIFT_NOMINAL_US    0       // 传感器标称帧周期 (us)；0: 以锁定时的估计为基准，ppm 只反映之后的变化
+#endif
+
+#define DRIFT_MAX_N         2048    // 等效拟合长度上限 (帧)，272ms 一帧时约 9 分钟 (再大增益乘法会溢出)
+#define DRIFT_LOCK_N        1024    // 拟合满这么多帧才给出 ppm (帧抖动 10ms 时斜率误差约 2ppm)
+#define DRIFT_GATE_MIN_US   20000   // 残差门限下限；门限取它和 4 倍抖动的大者
+#define DRIFT_MAX_GAP       32      // 一次跳过的帧超过它当断流，重新对相位
+
+typedef struct {
+    uint32_t last_tick;             // 上一个参与拟合的帧的到达时刻
+    int64_t  phase;                 // 拟合直线在该帧处的值减 last_tick (ms Q32)
+    int64_t  period;                // 帧周期 (ms Q32)
+    int64_t  ref;                   // ppm 的基准周期 (ms Q32)，0 表示还没有
+    uint32_t var_us2;               // 残差方差 (us^2)，1/16 平滑
+    uint16_t n;                     // 已拟合帧数 (到 DRIFT_MAX_N 为止)，0 表示还没收到帧
+    uint16_t outliers;              // 被截断或跳过的帧
+} Drift_t;
+
+void Drift_Reset(Drift_t *d);
+void Drift_Add(Drift_t *d, uint32_t tick);
+// 结果：帧周期 us，ppm x10 (本机毫秒比传感器快为正，未锁定为 0)，残差抖动 us，返回是否已锁定
+uint8_t Drift_Result(const Drift_t *d, uint32_t *period_us, int32_t *ppm_x10, uint16_t *jitter_us);
+// 本机相对时间 (ms) 按估计的漂移换算到传感器时钟；未锁定时原样返回
+int32_t Drift_Correct(const Drift_t *d, int32_t rel_ms);
+
+#endif /* DRIFT_H */
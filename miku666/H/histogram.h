@@ -0,0 +1,47 @@
+/*
+ * histogram.h
+ * ADC 原始码直方图：每个实例一张，箱宽 2^HIST_BIN_SHIFT 个码，16 位计数到顶不再加。
+ * 每个样本一次移位 + 一次比较 + 一次加 (HIST_ADD)，看缺码、噪声宽度、双峰不用再抓原始样本。
+ * 收到 CMD 0x74 时由主循环分块返回 (见 histogram.c)；内容 01 表示返回后清零，02 只清零不返回。
+ * MONITOR_HIST 为 0 时 HIST_ADD 为空，表也不占 RAM。
+ */
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "main.h"
+#include "Monitor_usart.h"
+
+#ifndef MONITOR_HIST
+#define MONITOR_HIST 0
+#endif
+
+// 箱宽位数：4 -> 16 码一箱，256 箱，每实例 512 字节；查缺码要用 0 (4096 箱，8KB，只适合单实例)
+#ifndef HIST_BIN_SHIFT
+#define HIST_BIN_SHIFT  4
+#endif
+
+#define HIST_CODES      4096    // 12 位 ADC
+#define HIST_BINS       (HIST_CODES >> HIST_BIN_SHIFT)
+
+#if MONITOR_HIST
+
+extern uint16_t g_hist[MONITOR_INSTANCES][HIST_BINS];
+
+// 主循环调用 (采样和导出都在主循环，不用关中断)
+static __inline void Hist_Add(uint8_t inst, uint32_t code) {
+    uint16_t *c = &g_hist[inst][(code & (HIST_CODES - 1)) >> HIST_BIN_SHIFT];
+    if (*c != 0xFFFF) (*c)++;
+}
+
+#define HIST_ADD(inst, code)  Hist_Add((inst), (code))
+
+#else
+
+#define HIST_ADD(inst, code)  ((void)0)
+
+#endif /* MONITOR_HIST */
+
+void Hist_Reset(void);             // 清零全部实例
+void Hist_Dump(uint8_t reset);     // 主循环调用：按 CMD 0x74 帧分块发出，reset 非 0 时发完清零
+
+#endif /* HISTOGRAM_H */
@@ -0,0 +1,49 @@
+/*
+ * hw_io.h
+ * 零开销外设访问：热路径上直接读写 GPIO/USART/ADC 寄存器
+ * 1. 引脚用 main.h 里 CubeMX 生成的名字 (LED0、BOTTON1、Monitor_SCK ...)，
+ *    IO_READ(BOTTON1) 展开成 BOTTON1_GPIO_Port->IDR & BOTTON1_Pin，端口和位都是常量，
+ *    编译出来就是一两条 LDR/STR，没有函数调用、句柄查表和参数检查。
+ * 2. 初始化仍用 HAL (MX_xxx_Init)；CubeMX 改了引脚只要重新生成 main.h，这里不用动。
+ */
+#ifndef HW_IO_H
+#define HW_IO_H
+
+#include "main.h"
+
+// ================= GPIO =================
+#define IO_PORT(pin)        (pin##_GPIO_Port)
+#define IO_MASK(pin)        (pin##_Pin)
+
+#define IO_READ(pin)        ((IO_PORT(pin)->IDR & IO_MASK(pin)) != 0u)   // 1: 高电平
+#define IO_HIGH(pin)        (IO_PORT(pin)->BSRR = IO_MASK(pin))
+#define IO_LOW(pin)         (IO_PORT(pin)->BRR = IO_MASK(pin))
+#define IO_WRITE(pin, v)    (IO_PORT(pin)->BSRR = (v) ? (uint32_t)IO_MASK(pin) : ((uint32_t)IO_MASK(pin) << 16))
+#define IO_TOGGLE(pin)      Io_Toggle(IO_PORT(pin), IO_MASK(pin))
+
+// 与 HAL_GPIO_TogglePin 同样用一次 BSRR 写，不会和中断里改同一端口的其它位冲突
+static __inline void Io_Toggle(GPIO_TypeDef *port, uint16_t mask) {
+    uint32_t odr = port->ODR;
+    port->BSRR = ((odr & mask) << 16) | (~odr & mask);
+}
+
+// ================= USART =================
+#define UART_TX_READY(u)    (((u)->SR & USART_SR_TXE) != 0u)
+#define UART_TX_DONE(u)     (((u)->SR & USART_SR_TC) != 0u)
+#define UART_RX_READY(u)    (((u)->SR & USART_SR_RXNE) != 0u)
+#define UART_PUT(u, b)      ((u)->DR = (uint8_t)(b))
+#define UART_GET(u)         ((uint8_t)((u)->DR))
+
+// 阻塞发送 (不走 HAL 句柄，不影响 HAL 的中断接收)
+static __inline void Uart_Write(USART_TypeDef *u, const uint8_t *p, uint16_t n) {
+    while (n--) {
+        while (!UART_TX_READY(u)) {}
+        UART_PUT(u, *p++);
+    }
+}
+
+// ================= ADC =================
+#define ADC_EOC(a)          (((a)->SR & ADC_SR_EOC) != 0u)
+#define ADC_VALUE(a)        ((uint16_t)((a)->DR))   // 读 DR 同时清 EOC，与 HAL_ADC_GetValue 相同
+
+#endif /* HW_IO_H */
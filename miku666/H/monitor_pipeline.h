@@ -0,0 +1,118 @@
+/*
+ * monitor_pipeline.h
+ * 监测流水线的编译期组合：采集 -> 滤波 -> 窗口 -> 输出，每一级用一个宏选实现。
+ * Monitor_usart.c 里每种策略的实现都包在 #if 里，只有选中的那一种参与编译，
+ * 主循环没有运行期分支，没选的代码 (比如 FRAME 输出时的 sprintf) 不进 Flash。
+ * 在 Keil 的 C/C++ Define 里改，例如 MONITOR_FILTER=MONITOR_FILTER_MEAN,MONITOR_FORMAT=MONITOR_FORMAT_FRAME。
+ */
+#ifndef MONITOR_PIPELINE_H
+#define MONITOR_PIPELINE_H
+
+// ---- 采集 ----
+#define MONITOR_ACQ_HAL       0   // HAL 启动 + 轮询 + 取值 (多实例时每次切通道)
+#define MONITOR_ACQ_REG       1   // ADC 上电后一直连续转换，采样时只看 EOC 读 DR，不等待 (只支持单实例)
+
+// ---- 滤波 (自带窗口内的累加状态) ----
+#define MONITOR_FILTER_MEDIAN 0   // 存下窗口内全部样本，打印时取中值
+#define MONITOR_FILTER_MEAN   1   // 只存和与个数，取平均 (四舍五入)
+#define MONITOR_FILTER_LAST   2   // 只留最后一个样本
+
+// ---- 输出 ----
+#define MONITOR_FORMAT_TEXT   0   // 文本报告行 [t s] T:x C, ADC:y
+#define MONITOR_FORMAT_FRAME  1   // JRZX 二进制帧 CMD 0x73 (见 Monitor_usart.h)，上位机 trace_dec --report 还原成文本
+
+#ifndef MONITOR_ACQ
+#define MONITOR_ACQ           MONITOR_ACQ_HAL
+#endif
+
+#ifndef MONITOR_FILTER
+#define MONITOR_FILTER        MONITOR_FILTER_MEDIAN
+#endif
+
+#ifndef MONITOR_FORMAT
+#define MONITOR_FORMAT        MONITOR_FORMAT_TEXT
+#endif
+
+// 1: 报告附带窗口统计 (ADC、温度各 个数/最小/最大/均值/标准差，见 win_stats.h)
+#ifndef MONITOR_STATS
+#define MONITOR_STATS         0
+#endif
+
+// 1: 变化才报告 (死区)。温度或 ADC 相对上次发出的值超过死区，或距上次发出满心跳间隔才发，
+//    报告里带上中间被压掉的窗口数；0: 每个窗口都报告
+#ifndef MONITOR_DEADBAND
+#define MONITOR_DEADBAND      0
+#endif
+
+#ifndef MONITOR_DEADBAND_TEMP
+#define MONITOR_DEADBAND_TEMP 2       // 温度死区 (0.1度)
+#endif
+
+#ifndef MONITOR_DEADBAND_ADC
+#define MONITOR_DEADBAND_ADC  8       // ADC 死区 (码)
+#endif
+
+#ifndef MONITOR_HEARTBEAT_MS
+#define MONITOR_HEARTBEAT_MS  5000    // 没有变化时最长多久报告一次
+#endif
+
+// 1: 报告附带 ADC 相对温度的延迟 (互相关，见 xcorr.h)，毫秒 + 相关系数
+#ifndef MONITOR_XCORR
+#define MONITOR_XCORR         0
+#endif
+
+// 1: 报告附带参考温度的稳态预测和辨识出的时间常数 (一阶滞后模型，见 thermal_model.h)
+#ifndef MONITOR_PREDICT
+#define MONITOR_PREDICT       0
+#endif
+
+// 1: 报告附带时间对齐的 (ADC, 温度) 对：温度按前后两帧线性插值到每个 ADC 采样时刻 (见 align.h)，
+//    对数、ADC 均值、温度均值 0.01度、过期个数；比原始报告晚约一个温度帧周期
+#ifndef MONITOR_ALIGN
+#define MONITOR_ALIGN         0
+#endif
+
+// 1: 报告附带传感器帧时钟相对本机的漂移 (帧周期、ppm、到达抖动，见 drift.h)
+#ifndef MONITOR_DRIFT
+#define MONITOR_DRIFT         0
+#endif
+
+// 1: 报告的相对时间按估计的漂移换算到传感器时钟 (需要 MONITOR_DRIFT，锁定之前不换算)
+#ifndef MONITOR_DRIFT_CORRECT
+#define MONITOR_DRIFT_CORRECT 0
+#endif
+
+// 1: 读 PB5~PB7 上的热电偶芯片 (MAX6675/MAX31855，见 thermocouple.h)，报告附带它的最新温度和故障位
+#ifndef MONITOR_TC
+#define MONITOR_TC            0
+#endif
+
+// ---- 窗口 ----
+#ifndef MONITOR_WINDOW_MS
+#define MONITOR_WINDOW_MS     250   // 报告周期，也是第一次报告前等待的时间
+#endif
+
+#ifndef MONITOR_SAMPLE_MS
+#define MONITOR_SAMPLE_MS     50    // ADC 采样周期
+#endif
+
+// 窗口内最多样本数 (250ms / 50ms = 5，预留一倍防止主循环被阻塞后补采溢出)
+#define MONITOR_WINDOW_SAMPLES  (2 * (MONITOR_WINDOW_MS / MONITOR_SAMPLE_MS))
+
+#if MONITOR_ACQ != MONITOR_ACQ_HAL && MONITOR_ACQ != MONITOR_ACQ_REG
+#error "MONITOR_ACQ: 取 MONITOR_ACQ_HAL 或 MONITOR_ACQ_REG"
+#endif
+#if MONITOR_FILTER != MONITOR_FILTER_MEDIAN && MONITOR_FILTER != MONITOR_FILTER_MEAN && MONITOR_FILTER != MONITOR_FILTER_LAST
+#error "MONITOR_FILTER: 取 MONITOR_FILTER_MEDIAN / MEAN / LAST"
+#endif
+#if MONITOR_FORMAT != MONITOR_FORMAT_TEXT && MONITOR_FORMAT != MONITOR_FORMAT_FRAME
+#error "MONITOR_FORMAT: 取 MONITOR_FORMAT_TEXT 或 MONITOR_FORMAT_FRAME"
+#endif
+#if MONITOR_DRIFT_CORRECT && !MONITOR_DRIFT
+#error "MONITOR_DRIFT_CORRECT 需要 MONITOR_DRIFT=1"
+#endif
+#if MONITOR_WINDOW_MS < MONITOR_SAMPLE_MS || MONITOR_WINDOW_SAMPLES > 255
+#error "MONITOR_WINDOW_MS / MONITOR_SAMPLE_MS 超出范围 (窗口内 1~127 个样本)"
+#endif
+
+#endif /* MONITOR_PIPELINE_H */
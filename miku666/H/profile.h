@@ -0,0 +1,64 @@
+/*
+ * profile.h
+ * DWT 周期计数性能分析：PROF_BEGIN(区段) / PROF_END(区段) 成对放在同一作用域，
+ * 每个区段累计 次数/最小/最大/总周期 (已扣除计时本身的开销)。
+ * MONITOR_PROFILE 为 0 时两个宏为空，表也不占 RAM。
+ * 收到 CMD 0x71 时由主循环按 JRZX 帧返回整张表 (见 profile.c)。
+ */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "main.h"
+#include "cycles.h"
+
+#ifndef MONITOR_PROFILE
+#define MONITOR_PROFILE 0
+#endif
+
+typedef enum {
+#define PROF_ZONE(name) PZ_##name,
+#include "profile_zones.def"
+#undef PROF_ZONE
+    PZ_COUNT
+} ProfZone_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} ProfStat_t;
+
+#if MONITOR_PROFILE
+
+extern ProfStat_t g_prof[PZ_COUNT];
+extern uint32_t g_prof_overhead;   // 空区段的周期数，Prof_Init 时测得
+
+// 中断和主循环都可调用
+static __inline void Prof_Add(ProfZone_t zone, uint32_t cycles) {
+    ProfStat_t *s = &g_prof[zone];
+    uint32_t primask = __get_PRIMASK();
+    cycles = (cycles > g_prof_overhead) ? cycles - g_prof_overhead : 0;
+    __disable_irq();
+    if (cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+    s->total += cycles;
+    s->count++;
+    __set_PRIMASK(primask);
+}
+
+#define PROF_BEGIN(zone)  uint32_t prof_t0_##zone = CYCLES_NOW()
+#define PROF_END(zone)    Prof_Add(PZ_##zone, CYCLES_NOW() - prof_t0_##zone)
+
+#else
+
+#define PROF_BEGIN(zone)  ((void)0)
+#define PROF_END(zone)    ((void)0)
+
+#endif /* MONITOR_PROFILE */
+
+void Prof_Init(void);              // 打开 DWT，测计时开销，清表
+void Prof_Reset(void);             // 清表
+void Prof_Dump(uint8_t reset);     // 主循环调用：按 CMD 0x71 帧发出整张表，reset 非 0 时发完清表
+
+#endif /* PROFILE_H */
@@ -0,0 +1,20 @@
+/*
+ * ramfunc.h
+ * RAMFUNC：把函数放进 .ramfunc 段，由 MDK-ARM/ramfunc.sct 安排在 SRAM 执行 (零等待)。
+ * 只用于中断里每字节都要走的短函数；SRAM 总共 20KB，别滥用。
+ */
+#ifndef RAMFUNC_H
+#define RAMFUNC_H
+
+// 0: RAMFUNC 为空，全部留在 Flash (对比前后周期时用，链接器也要同样定义，见 ramfunc.sct)
+#ifndef MONITOR_RAMFUNC
+#define MONITOR_RAMFUNC 1
+#endif
+
+#if MONITOR_RAMFUNC
+#define RAMFUNC  __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+#endif /* RAMFUNC_H */
@@ -0,0 +1,17 @@
+/*
+ * stack_watch.h
+ * 栈高水位：启动文件在 Reset_Handler 里把整个栈涂成 STACK_PAINT，
+ * 空闲时从栈底往上数还保持涂色的字，得到历史最深用量。
+ */
+#ifndef STACK_WATCH_H
+#define STACK_WATCH_H
+
+#include "main.h"
+
+#define STACK_PAINT         0xA5A5A5A5u   // 与 startup_stm32f103xb.s 里的值一致
+
+void Stack_Watch_Scan(void);          // 扫描一次，更新高水位 (栈 1KB 时最多 256 次读，约十几微秒)
+uint16_t Stack_Watch_Size(void);      // 栈总字节数
+uint16_t Stack_Watch_Peak(void);      // 上电以来最深用量 (字节)，取最近一次扫描的结果
+
+#endif /* STACK_WATCH_H */
@@ -0,0 +1,32 @@
+/*
+ * thermal_model.h
+ * 参考温度传感器的一阶滞后模型：在线辨识时间常数，预测它最终会稳定到的温度。
+ * 阶跃响应里相邻两帧的增量之比 r = d[k]/d[k-1] 是常数 (= e^(-帧周期/tau))，
+ * 用带遗忘的最小二乘估 r，剩下还没走完的变化 = d*r/(1-r)。全整数。
+ * Thermal_Add 在收到温度帧时调用 (中断里)，Thermal_Predict 在主循环对快照调用。
+ */
+#ifndef THERMAL_MODEL_H
+#define THERMAL_MODEL_H
+
+#include "main.h"
+
+#define THERMAL_R_Q         12      // r 的定点位数
+#define THERMAL_MIN_STEP    2       // 增量小于它 (0.1度) 当噪声，不参与辨识也不外推
+#define THERMAL_FORGET      5       // 遗忘：每次更新先减去 1/32
+
+typedef struct {
+    int16_t  last_temp;       // 上一帧温度 (0.1度)
+    int16_t  last_diff;       // 最近一次增量
+    uint32_t last_tick;
+    uint16_t period_ms;       // 帧周期 (平滑后)
+    uint8_t  frames;          // 已收帧数 (到 2 为止)
+    int32_t  sxy;             // Σ d[k]*d[k-1] x16
+    int32_t  sxx;             // Σ d[k-1]^2 x16
+} ThermalModel_t;
+
+void Thermal_Reset(ThermalModel_t *t);
+void Thermal_Add(ThermalModel_t *t, int16_t temp_deci, uint32_t tick);
+// 预测稳态温度 (0.1度，限定在 lo~hi) 和时间常数 (ms，0 表示还没辨识出来)
+void Thermal_Predict(const ThermalModel_t *t, int16_t lo, int16_t hi, int16_t *pred_deci, uint16_t *tau_ms);
+
+#endif /* THERMAL_MODEL_H */
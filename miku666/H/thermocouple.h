@@ -0,0 +1,36 @@
+/*
+ * thermocouple.h
+ * 热电偶转换芯片 (MAX6675 / MAX31855) 读取：PB5 Monitor_CS、PB6 Monitor_SCK、PB7 Monitor_SO 软件模拟 SPI。
+ * 读一次要 16/32 个时钟，拆成状态机：主循环每次调 TC_Step 只走一步 (拉一次 CS 或 SCK、读一位)，
+ * 一次读数分散在几十次主循环里完成，单次调用是固定的几条寄存器读写，不会卡住采样和打印。
+ * 结果作为第三路参考温度附在报告里 (MONITOR_TC，见 monitor_pipeline.h)。
+ */
+#ifndef THERMOCOUPLE_H
+#define THERMOCOUPLE_H
+
+#include "main.h"
+#include "monitor_pipeline.h"
+
+#define TC_CHIP_MAX6675     0   // 16 位，0.25度，只有开路故障，转换 220ms
+#define TC_CHIP_MAX31855    1   // 32 位，0.25度有符号，开路/对地短路/对电源短路，转换 100ms
+
+#ifndef TC_CHIP
+#define TC_CHIP             TC_CHIP_MAX6675
+#endif
+
+#ifndef TC_PERIOD_MS
+#define TC_PERIOD_MS        250     // 两次读之间的间隔，要长于芯片转换时间 (CS 拉高后开始转换)
+#endif
+
+// 故障位 (MAX6675 只会有 OPEN)
+#define TC_FAULT_OPEN       0x01    // 热电偶开路 (没接芯片时 SO 被上拉，也读成这个)
+#define TC_FAULT_SCG        0x02    // 对地短路
+#define TC_FAULT_SCV        0x04    // 对电源短路
+#define TC_FAULT_NONE       0x80    // 还没读到过
+
+void TC_Init(void);                 // CS、SCK 改成推挽输出 (CubeMX 里是上拉输入)
+void TC_Step(uint32_t now);         // 主循环每次调用
+// 最近一次读数 (0.1度)；返回故障位，0 表示读数有效
+uint8_t TC_Get(int16_t *temp_deci);
+
+#endif /* THERMOCOUPLE_H */
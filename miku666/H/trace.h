@@ -0,0 +1,67 @@
+/*
+ * trace.h
+ * 二进制事件跟踪：固定 12 字节事件 (DWT 时间戳 + 事件号 + 两个参数) 写进 SRAM 环形缓冲，
+ * 写满覆盖最旧的。记录一条只是关中断下的几次存储，不影响时序；
+ * 收到 CMD 0x70 时由主循环按 JRZX 帧导出，上位机 trace_dec 解成时间线。
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "main.h"
+#include "cycles.h"
+
+// 0: TRACE() 全部编译为空，环形缓冲也不占 RAM。默认关，要用的目标在 Keil 的 C/C++ Define 里加 MONITOR_TRACE=1
+#ifndef MONITOR_TRACE
+#define MONITOR_TRACE 0
+#endif
+
+#define TRACE_DEPTH         128   // 事件条数，必须是 2 的幂 (128 x 12B = 1.5KB)
+
+typedef enum {
+#define TRACE_EVENT(name, a0, a1) TRC_##name,
+#include "trace_events.def"
+#undef TRACE_EVENT
+    TRC_COUNT
+} TraceId_t;
+
+typedef struct {
+    uint32_t ts;    // DWT->CYCCNT
+    uint16_t id;    // TraceId_t
+    uint16_t a0;
+    uint32_t a1;
+} TraceEvent_t;
+
+#if MONITOR_TRACE
+
+extern TraceEvent_t g_trace_ring[TRACE_DEPTH];
+extern volatile uint32_t g_trace_head;   // 累计写入条数 (不取模)
+extern volatile uint8_t g_trace_on;      // 导出期间为 0，冻结缓冲
+
+// 中断和主循环都可调用
+static __inline void Trace_Record(uint16_t id, uint16_t a0, uint32_t a1) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (g_trace_on) {
+        TraceEvent_t *e = &g_trace_ring[g_trace_head & (TRACE_DEPTH - 1)];
+        e->ts = CYCLES_NOW();
+        e->id = id;
+        e->a0 = a0;
+        e->a1 = a1;
+        g_trace_head++;
+    }
+    __set_PRIMASK(primask);
+}
+
+#define TRACE(name, a0, a1)  Trace_Record(TRC_##name, (uint16_t)(a0), (uint32_t)(a1))
+
+#else
+
+// 参数只放进 sizeof，不求值 (HAL_GetTick() 之类不会被调用)，但算"用过"，只给 TRACE 用的局部变量不报未使用
+#define TRACE(name, a0, a1)  ((void)sizeof(a0), (void)sizeof(a1))
+
+#endif /* MONITOR_TRACE */
+
+void Trace_Init(void);   // 打开 DWT，清空缓冲
+void Trace_Dump(void);   // 主循环调用：冻结缓冲，按 CMD 0x70 帧发出全部事件 (阻塞)
+
+#endif /* TRACE_H */
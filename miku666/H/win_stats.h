@@ -0,0 +1,66 @@
+/*
+ * win_stats.h
+ * 报告窗口内的流式统计：个数/最小/最大/均值/标准差，Welford 算法，全整数。
+ * 每个样本 O(1)：一次除法 (M3 有硬件除法) 和一次 32x32->64 乘加，可以在中断里调用。
+ * 均值和离差按 1/256 定点 (样本左移 8 位) 累计，开方只在取结果时做一次。
+ */
+#ifndef WIN_STATS_H
+#define WIN_STATS_H
+
+#include "main.h"
+
+#define WIN_STATS_Q     8                   // 定点小数位
+#define WIN_STATS_ONE   (1L << WIN_STATS_Q)
+
+typedef struct {
+    uint16_t n;
+    int16_t  min;
+    int16_t  max;
+    int32_t  mean_q;   // 均值 x256
+    int64_t  m2_q;     // 离差平方和 x65536
+} WinStats_t;
+
+static __inline void WinStats_Reset(WinStats_t *s) {
+    s->n = 0;
+    s->mean_q = 0;
+    s->m2_q = 0;
+}
+
+static __inline void WinStats_Add(WinStats_t *s, int16_t x) {
+    int32_t xq = (int32_t)x << WIN_STATS_Q;
+    int32_t delta = xq - s->mean_q;
+
+    if (s->n == 0 || x < s->min) s->min = x;
+    if (s->n == 0 || x > s->max) s->max = x;
+    if (s->n < 0xFFFF) s->n++;
+    s->mean_q += delta / (int32_t)s->n;
+    s->m2_q += (int64_t)delta * (xq - s->mean_q);
+}
+
+// 均值 x10 (四舍五入)
+static __inline int32_t WinStats_Mean10(const WinStats_t *s) {
+    int32_t v = s->mean_q * 10;
+    return (v >= 0) ? (v + WIN_STATS_ONE / 2) >> WIN_STATS_Q : -((-v + WIN_STATS_ONE / 2) >> WIN_STATS_Q);
+}
+
+// 总体标准差 x10 (四舍五入)，n 为 0 时返回 0
+static __inline uint32_t WinStats_Sd10(const WinStats_t *s) {
+    if (s->n == 0 || s->m2_q <= 0) return 0;
+    uint64_t var = (uint64_t)s->m2_q / s->n;   // 方差 x65536
+    // 逐位开方，结果是标准差 x256
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > var) bit >>= 2;
+    while (bit) {
+        if (var >= root + bit) {
+            var -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)((root * 10 + WIN_STATS_ONE / 2) >> WIN_STATS_Q);
+}
+
+#endif /* WIN_STATS_H */
@@ -0,0 +1,44 @@
+/*
+ * xcorr.h
+ * ADC 与参考温度的互相关延迟估计：每个报告窗口送一对 (ADC, 温度)，
+ * 对两路的一阶差分做互相关，找相关最强的延迟。
+ * 每个延迟的乘积和随窗口增量更新 (加新对、减掉出环的那对)，每窗口 O(最大延迟)。
+ * 延迟为正表示 ADC 比温度晚变化。
+ */
+#ifndef XCORR_H
+#define XCORR_H
+
+#include "main.h"
+
+#ifndef XCORR_LEN
+#define XCORR_LEN       64    // 环长 (窗口数)，250ms 窗口时 16s
+#endif
+
+#ifndef XCORR_MAX_LAG
+#define XCORR_MAX_LAG   16    // 搜索 ±16 个窗口 (±4s)
+#endif
+
+#define XCORR_LAGS      (2 * XCORR_MAX_LAG + 1)
+
+#if XCORR_MAX_LAG >= XCORR_LEN || (XCORR_LEN & (XCORR_LEN - 1))
+#error "XCORR_LEN 要是 2 的幂且大于 XCORR_MAX_LAG"
+#endif
+
+typedef struct {
+    int16_t  dx[XCORR_LEN];        // ADC 差分
+    int16_t  dy[XCORR_LEN];        // 温度差分 (0.1度)
+    int32_t  sxy[XCORR_LAGS];      // 每个延迟的 Σ dy[t]*dx[t+d]
+    uint32_t exx;                  // 环内 Σ dx^2
+    uint32_t eyy;                  // 环内 Σ dy^2
+    uint32_t seq;                  // 已入环的差分对数
+    int32_t  prev_x;
+    int16_t  prev_y;
+    uint8_t  primed;               // 已有上一对 (可以求差分)
+} XCorr_t;
+
+void XCorr_Reset(XCorr_t *c);
+void XCorr_Add(XCorr_t *c, int32_t adc, int16_t temp_deci);
+// 结果：延迟 (窗口数 x256，已做抛物线插值) 和相关系数 x100 (带符号，0 表示没有可用的变化)
+void XCorr_Result(const XCorr_t *c, int32_t *lag_q8, int8_t *rho_pct);
+
+#endif /* XCORR_H */
@@ -0,0 +1,129 @@
+/*
+ * bench_cmp.cpp
+ * 对比 ADC_Bench 固件的基准测试输出 (#BENCH_BEGIN ... #BENCH_END 块)
+ * 每个文件取最后一个完整的块；第一个文件作基线，其余按平均周期给出变化百分比。
+ * 实板和 Renode 的数值不可混比 (见 MDK-ARM/renode/bench_stm32f103.resc)。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/bench_cmp.cpp -o bench_cmp
+ * 用法：bench_cmp [--csv] 基线输出.txt [新输出.txt...]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+struct BenchRow {
+    std::string unit;
+    unsigned long iters = 0, min = 0, mean = 0, max = 0;
+};
+
+struct BenchBlock {
+    std::string header;                       // #BENCH_BEGIN 行其余部分
+    std::vector<std::string> order;           // 用例出现顺序
+    std::map<std::string, BenchRow> rows;
+};
+
+static void Usage(void) {
+    std::fprintf(stderr, "用法: bench_cmp [--csv] 基线输出.txt [新输出.txt...]\n");
+}
+
+static void Chomp(char* s) {
+    size_t n = std::strlen(s);
+    while (n && (s[n - 1] == '\n' || s[n - 1] == '\r')) s[--n] = '\0';
+}
+
+// 读出文件中最后一个完整块
+static bool Load_Block(const std::string& path, BenchBlock* out) {
+    FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) {
+        std::perror(path.c_str());
+        return false;
+    }
+    char line[256];
+    BenchBlock cur;
+    bool in_block = false, found = false;
+    while (std::fgets(line, sizeof(line), f)) {
+        Chomp(line);
+        const char* p = std::strstr(line, "#BENCH_BEGIN");
+        if (p) {
+            cur = BenchBlock();
+            cur.header = p + std::strlen("#BENCH_BEGIN");
+            in_block = true;
+            continue;
+        }
+        if (!in_block) continue;
+        if (std::strstr(line, "#BENCH_END")) {
+            *out = cur;
+            found = true;
+            in_block = false;
+            continue;
+        }
+        // case,unit,iters,min,mean,max
+        char name[64], unit[32];
+        BenchRow r;
+        if (std::sscanf(line, "%63[^,],%31[^,],%lu,%lu,%lu,%lu", name, unit, &r.iters, &r.min, &r.mean, &r.max) == 6) {
+            r.unit = unit;
+            if (!cur.rows.count(name)) cur.order.push_back(name);
+            cur.rows[name] = r;
+        }
+    }
+    std::fclose(f);
+    if (!found) std::fprintf(stderr, "%s: 没有完整的 #BENCH 块\n", path.c_str());
+    return found;
+}
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--csv") csv = true;
+        else if (a.size() > 1 && a[0] == '-') { Usage(); return 2; }
+        else files.push_back(a);
+    }
+    if (files.empty()) {
+        Usage();
+        return 2;
+    }
+
+    std::vector<BenchBlock> blocks(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!Load_Block(files[i], &blocks[i])) return 1;
+    }
+
+    const BenchBlock& base = blocks[0];
+    if (csv) {
+        std::printf("case,unit,file,min,mean,max,delta_mean_pct\n");
+    } else {
+        for (size_t i = 0; i < files.size(); i++) std::printf("# [%zu] %s:%s\n", i, files[i].c_str(), blocks[i].header.c_str());
+        std::printf("%-18s %-7s", "case", "unit");
+        for (size_t i = 0; i < files.size(); i++) std::printf(" %12s", ("mean[" + std::to_string(i) + "]").c_str());
+        std::printf("   (min 在括号内，变化相对 [0])\n");
+    }
+
+    for (const std::string& name : base.order) {
+        const BenchRow& b = base.rows.at(name);
+        if (!csv) std::printf("%-18s %-7s", name.c_str(), b.unit.c_str());
+        for (size_t i = 0; i < blocks.size(); i++) {
+            auto it = blocks[i].rows.find(name);
+            if (it == blocks[i].rows.end()) {
+                if (!csv) std::printf(" %12s", "-");
+                continue;
+            }
+            const BenchRow& r = it->second;
+            double delta = b.mean ? 100.0 * ((double)r.mean - (double)b.mean) / (double)b.mean : 0.0;
+            if (csv) {
+                std::printf("%s,%s,%zu,%lu,%lu,%lu,%.1f\n", name.c_str(), r.unit.c_str(), i, r.min, r.mean, r.max, delta);
+            } else if (i == 0) {
+                std::printf(" %12lu", r.mean);
+            } else {
+                std::printf(" %12lu (%lu, %+.1f%%)", r.mean, r.min, delta);
+            }
+        }
+        if (!csv) std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,444 @@
+/*
+ * calib_fit.cpp
+ * ADC -> 温度 离线标定拟合，生成固件可直接包含的查找表头文件
+ * 功能：
+ * 1. 读入一个或多个固件输出抓包 ([t] T:x C, ADC:y)，每行就是一对 (ADC, 温度)。
+ * 2. 拟合两种模型：分段线性 (节点间距 2^shift 个码) 和多项式，均带离群点剔除
+ *    (按残差 MAD 迭代剔除)。输出每种模型的点数/剔除数/RMS/最大误差。
+ * 3. 生成 calib_table.h：int16 表 (0.1度) + 整数插值函数，覆盖 0..4095 全量程，
+ *    数据范围外夹到边界值。分段线性的节点就是表的节点，所以表本身就是最小二乘最优解，
+ *    只剩取整误差 (同时报告按固件整数算法复算的误差)。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/calib_fit.cpp -o calib_fit
+ * 用法：calib_fit [--model pwl|poly] [--shift 7] [--degree 3] [--reject 3.0]
+ *                 [-o miku666/H/calib_table.h] 抓包.txt...
+ *       calib_fit --selftest [--shift 7]    合成 NTC (下降) 曲线拟合，核对整数表与模型相差不超过 0.5 个 0.1度，
+ *                                           以及只覆盖部分量程的多项式在数据范围外夹到边界值
+ */
+
+#include "report_line.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ================= 参数 =================
+#define ADC_CODES      4096
+#define MIN_THRESH_C   0.05    // 剔除阈值下限 (度)，避免数据极干净时把正常点剔掉
+#define MAX_ITER       10
+#define SMOOTH_LAMBDA  1e-3    // 分段线性二阶差分正则，数据有空洞时保证可解
+
+struct Options {
+    std::string model = "pwl";
+    int shift = 7;              // 节点间距 128 码 -> 33 个节点
+    int degree = 3;
+    double reject_k = 3.0;      // 剔除阈值 = k * 1.4826 * MAD
+    std::string out = "calib_table.h";
+    bool selftest = false;
+    std::vector<std::string> files;
+};
+
+struct Point {
+    double adc;
+    double temp;
+};
+
+// ================= 线性代数 =================
+// 列主元高斯消元，A 为 n*n 行主序，解存回 b。奇异返回 false
+static bool Solve_Dense(std::vector<double>& A, std::vector<double>& b, int n) {
+    for (int c = 0; c < n; c++) {
+        int piv = c;
+        for (int r = c + 1; r < n; r++)
+            if (std::fabs(A[r * n + c]) > std::fabs(A[piv * n + c])) piv = r;
+        if (std::fabs(A[piv * n + c]) < 1e-12) return false;
+        if (piv != c) {
+            for (int k = 0; k < n; k++) std::swap(A[c * n + k], A[piv * n + k]);
+            std::swap(b[c], b[piv]);
+        }
+        for (int r = c + 1; r < n; r++) {
+            double f = A[r * n + c] / A[c * n + c];
+            if (f == 0.0) continue;
+            for (int k = c; k < n; k++) A[r * n + k] -= f * A[c * n + k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = n - 1; r >= 0; r--) {
+        double s = b[r];
+        for (int k = r + 1; k < n; k++) s -= A[r * n + k] * b[k];
+        b[r] = s / A[r * n + r];
+    }
+    return true;
+}
+
+// ================= 模型 =================
+// 分段线性：节点 knot_lo..knot_hi (单位：节点序号，ADC = 序号 << shift)
+struct PwlModel {
+    int shift = 7;
+    int knot_lo = 0, knot_hi = 0;
+    std::vector<double> y;      // 每个节点的温度
+
+    double eval(double adc) const {
+        double step = (double)(1 << shift);
+        double k = adc / step;
+        if (k <= knot_lo) return y.front();
+        if (k >= knot_hi) return y.back();
+        int j = (int)k;
+        double u = k - j;
+        return y[j - knot_lo] * (1.0 - u) + y[j - knot_lo + 1] * u;
+    }
+};
+
+static bool Fit_Pwl(const std::vector<Point>& pts, int shift, PwlModel* m) {
+    double step = (double)(1 << shift);
+    double lo = pts[0].adc, hi = pts[0].adc;
+    for (const Point& p : pts) { lo = std::min(lo, p.adc); hi = std::max(hi, p.adc); }
+    m->shift = shift;
+    m->knot_lo = (int)std::floor(lo / step);
+    m->knot_hi = std::max((int)std::ceil(hi / step), m->knot_lo + 1);
+    int n = m->knot_hi - m->knot_lo + 1;
+
+    std::vector<double> A(n * n, 0.0), b(n, 0.0);
+    for (const Point& p : pts) {
+        double k = p.adc / step - m->knot_lo;
+        int j = std::min((int)k, n - 2);
+        double u = k - j;
+        double w0 = 1.0 - u, w1 = u;
+        A[j * n + j] += w0 * w0;
+        A[j * n + j + 1] += w0 * w1;
+        A[(j + 1) * n + j] += w0 * w1;
+        A[(j + 1) * n + j + 1] += w1 * w1;
+        b[j] += w0 * p.temp;
+        b[j + 1] += w1 * p.temp;
+    }
+    // 二阶差分正则 (y[j-1] - 2y[j] + y[j+1])^2
+    for (int j = 1; j + 1 < n; j++) {
+        const int idx[3] = {j - 1, j, j + 1};
+        const double c[3] = {1.0, -2.0, 1.0};
+        for (int r = 0; r < 3; r++)
+            for (int s = 0; s < 3; s++) A[idx[r] * n + idx[s]] += SMOOTH_LAMBDA * c[r] * c[s];
+    }
+    if (!Solve_Dense(A, b, n)) return false;
+    m->y = b;
+    return true;
+}
+
+// 多项式：x 归一化到 [-1,1] 改善条件数；数据范围外不外推，夹到边界 (与分段线性一致)
+struct PolyModel {
+    double x0 = 0.0, xs = 1.0;
+    double lo = 0.0, hi = 0.0;  // 拟合数据的 ADC 范围
+    std::vector<double> c;      // c[0] + c[1]x + ...
+
+    double eval(double adc) const {
+        double x = (std::min(std::max(adc, lo), hi) - x0) / xs;
+        double v = 0.0;
+        for (int i = (int)c.size() - 1; i >= 0; i--) v = v * x + c[i];
+        return v;
+    }
+};
+
+static bool Fit_Poly(const std::vector<Point>& pts, int degree, PolyModel* m) {
+    double lo = pts[0].adc, hi = pts[0].adc;
+    for (const Point& p : pts) { lo = std::min(lo, p.adc); hi = std::max(hi, p.adc); }
+    m->lo = lo;
+    m->hi = hi;
+    m->x0 = 0.5 * (lo + hi);
+    m->xs = std::max(0.5 * (hi - lo), 1.0);
+    int n = degree + 1;
+    std::vector<double> A(n * n, 0.0), b(n, 0.0), pw(2 * n);
+    for (const Point& p : pts) {
+        double x = (p.adc - m->x0) / m->xs;
+        pw[0] = 1.0;
+        for (int i = 1; i < 2 * n; i++) pw[i] = pw[i - 1] * x;
+        for (int r = 0; r < n; r++) {
+            for (int s = 0; s < n; s++) A[r * n + s] += pw[r + s];
+            b[r] += pw[r] * p.temp;
+        }
+    }
+    if (!Solve_Dense(A, b, n)) return false;
+    m->c = b;
+    return true;
+}
+
+// ================= 离群剔除 =================
+struct FitReport {
+    size_t used = 0, rejected = 0;
+    double rms = 0.0, max_err = 0.0;
+};
+
+static double Median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    return v[mid];
+}
+
+// fit(inliers) -> bool；eval(adc) -> 温度。返回最终内点集及其误差统计
+template <typename FitFn, typename EvalFn>
+static bool Robust_Fit(const std::vector<Point>& all, double k, FitFn fit, EvalFn eval,
+                       FitReport* rep, std::vector<Point>* kept) {
+    std::vector<char> inlier(all.size(), 1);
+    std::vector<Point> use = all;
+    for (int iter = 0; iter < MAX_ITER; iter++) {
+        if (use.size() < 2 || !fit(use)) return false;
+        std::vector<double> res;
+        res.reserve(use.size());
+        for (const Point& p : use) res.push_back(std::fabs(p.temp - eval(p.adc)));
+        double thr = std::max(k * 1.4826 * Median(res), MIN_THRESH_C);
+
+        bool changed = false;
+        std::vector<Point> next;
+        for (size_t i = 0; i < all.size(); i++) {
+            char in = std::fabs(all[i].temp - eval(all[i].adc)) <= thr;
+            if (in != inlier[i]) changed = true;
+            inlier[i] = in;
+            if (in) next.push_back(all[i]);
+        }
+        use.swap(next);
+        if (!changed) break;
+    }
+    if (use.size() < 2 || !fit(use)) return false;
+
+    double sq = 0.0, mx = 0.0;
+    for (const Point& p : use) {
+        double e = std::fabs(p.temp - eval(p.adc));
+        sq += e * e;
+        mx = std::max(mx, e);
+    }
+    rep->used = use.size();
+    rep->rejected = all.size() - use.size();
+    rep->rms = std::sqrt(sq / use.size());
+    rep->max_err = mx;
+    kept->swap(use);
+    return true;
+}
+
+static void Print_Report(const char* name, const FitReport& r) {
+    std::printf("%-6s 使用 %zu 点, 剔除 %zu, RMS %.3f C, 最大误差 %.3f C\n",
+                name, r.used, r.rejected, r.rms, r.max_err);
+}
+
+// ================= 整数表 =================
+// 与生成头文件里 Calib_ADC_To_Deci 完全相同的整数算法
+// 插值量按绝对值四舍五入再带回符号：负数直接右移是向负无穷取整，下降曲线 (NTC) 会整体偏低
+static int Table_Lookup(const std::vector<int>& t, int shift, int adc) {
+    int j = adc >> shift;
+    int frac = adc & ((1 << shift) - 1);
+    if (j >= (int)t.size() - 1) return t.back();
+    int x = (t[j + 1] - t[j]) * frac;
+    int half = 1 << (shift - 1);
+    return t[j] + (x >= 0 ? (x + half) >> shift : -((-x + half) >> shift));
+}
+
+template <typename EvalFn>
+static std::vector<int> Build_Table(int shift, EvalFn eval) {
+    int points = (ADC_CODES >> shift) + 1;
+    std::vector<int> t(points);
+    for (int j = 0; j < points; j++) {
+        double v = std::round(eval((double)(j << shift)) * 10.0);
+        t[j] = (int)std::clamp(v, -32768.0, 32767.0);
+    }
+    return t;
+}
+
+static bool Write_Header(const std::string& path, const std::vector<int>& t, int shift,
+                         const char* model, const FitReport& rep) {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f,
+        "/*\n"
+        " * calib_table.h\n"
+        " * 由 tools/calib_fit.cpp 生成，不要手改\n"
+        " * 模型：%s，%zu 点 (剔除 %zu)，RMS %.3f C，最大误差 %.3f C\n"
+        " * 用法：int16_t t = Calib_ADC_To_Deci(adc);  // 0.1度\n"
+        " */\n"
+        "#ifndef CALIB_TABLE_H\n"
+        "#define CALIB_TABLE_H\n\n"
+        "#include <stdint.h>\n\n"
+        "#define CALIB_SHIFT   %d\n"
+        "#define CALIB_POINTS  %zu\n"
+        "#define CALIB_HALF    (1 << (CALIB_SHIFT - 1))\n\n"
+        "static const int16_t calib_table[CALIB_POINTS] = {",
+        model, rep.used, rep.rejected, rep.rms, rep.max_err, shift, t.size());
+    for (size_t i = 0; i < t.size(); i++) {
+        std::fprintf(f, "%s%6d%s", (i % 8 == 0) ? "\n    " : " ", t[i], (i + 1 < t.size()) ? "," : "");
+    }
+    std::fprintf(f,
+        "\n};\n\n"
+        "// 节点间线性插值，四舍五入，结果单位 0.1度\n"
+        "static __inline int16_t Calib_ADC_To_Deci(uint16_t adc) {\n"
+        "    uint32_t j = adc >> CALIB_SHIFT;\n"
+        "    int32_t frac = adc & ((1u << CALIB_SHIFT) - 1u);\n"
+        "    int32_t x;\n"
+        "    if (j >= CALIB_POINTS - 1) return calib_table[CALIB_POINTS - 1];\n"
+        "    x = (calib_table[j + 1] - calib_table[j]) * frac;\n"
+        "    // 按绝对值舍入再带回符号 (负数右移是向负无穷取整)\n"
+        "    x = (x >= 0) ? (x + CALIB_HALF) >> CALIB_SHIFT : -((-x + CALIB_HALF) >> CALIB_SHIFT);\n"
+        "    return (int16_t)(calib_table[j] + x);\n"
+        "}\n\n"
+        "#endif /* CALIB_TABLE_H */\n");
+    std::fclose(f);
+    return true;
+}
+
+// ================= 自测 =================
+// NTC 分压 (B=3950，10k 上拉，12 位 ADC)：温度越高 ADC 越低，表的斜率全为负。
+// 分段线性模型在节点间本来就是直线，整数表只差两处取整：节点 (±0.5) 和插值结果 (±0.5)。
+// 插值结果的舍入对照"整数节点的精确插值"应在 ±0.5 以内；对照模型看平均偏差，取整对称时接近 0。
+static int Self_Test(const Options& opt) {
+    auto ntc = [](int lo, int hi) {
+        std::vector<Point> v;
+        for (int adc = lo; adc <= hi; adc += 3) {
+            double r = 10000.0 * adc / (ADC_CODES - adc);
+            double t = 1.0 / (1.0 / 298.15 + std::log(r / 10000.0) / 3950.0) - 273.15;
+            v.push_back({(double)adc, t});
+        }
+        return v;
+    };
+    std::vector<Point> pts = ntc(400, 3700);
+    PwlModel pwl;
+    if (!Fit_Pwl(pts, opt.shift, &pwl)) {
+        std::printf("selftest: 拟合失败\n");
+        return 1;
+    }
+    std::vector<int> table = Build_Table(opt.shift, [&](double x) { return pwl.eval(x); });
+
+    int bad = 0;
+    double bias = 0.0, worst_interp = 0.0, worst_model = 0.0;
+    int n = 0;
+    for (int adc = 400; adc <= 3700; adc++) {
+        int got = Table_Lookup(table, opt.shift, adc);
+        int j = adc >> opt.shift;
+        double u = (double)(adc & ((1 << opt.shift) - 1)) / (1 << opt.shift);
+        double exact = table[j] + (table[j + 1] - table[j]) * u;
+        double di = got - exact, dm = got - pwl.eval(adc) * 10.0;
+        if (std::fabs(di) > 0.5 + 1e-9) bad++;
+        worst_interp = std::max(worst_interp, std::fabs(di));
+        worst_model = std::max(worst_model, std::fabs(dm));
+        bias += dm;
+        n++;
+    }
+    bias /= n;
+    bool ok = bad == 0 && std::fabs(bias) < 0.1;
+    std::printf("selftest: %d 点, 插值舍入最大 %.3f (超 0.5 的 %d 点), 对模型平均偏差 %+.3f 最大 %.3f (0.1度): %s\n",
+                n, worst_interp, bad, bias, worst_model, ok ? "OK" : "FAIL");
+
+    // 只覆盖部分量程的多项式：数据范围外应夹到边界值，整张表不超出数据的温度范围
+    std::vector<Point> part = ntc(1500, 2500);
+    double t_lo = part.back().temp * 10.0, t_hi = part.front().temp * 10.0;   // NTC：ADC 大温度低
+    for (int degree : {3, 8}) {
+        PolyModel poly;
+        if (!Fit_Poly(part, degree, &poly)) {
+            std::printf("selftest: %d 阶多项式拟合失败\n", degree);
+            return 1;
+        }
+        std::vector<int> t = Build_Table(opt.shift, [&](double x) { return poly.eval(x); });
+        auto mm = std::minmax_element(t.begin(), t.end());
+        bool in = *mm.first >= std::floor(t_lo) - 1 && *mm.second <= std::ceil(t_hi) + 1;
+        std::printf("selftest: %d 阶多项式 (ADC 1500~2500)，表两端 %.1f / %.1f，表范围 %.1f~%.1f (数据 %.1f~%.1f 度): %s\n",
+                    degree, t.front() / 10.0, t.back() / 10.0, *mm.first / 10.0, *mm.second / 10.0, t_lo / 10.0,
+                    t_hi / 10.0, in ? "OK" : "FAIL");
+        ok = ok && in;
+    }
+    return ok ? 0 : 1;
+}
+
+// ================= 主函数 =================
+static void Usage(void) {
+    std::fprintf(stderr,
+        "用法: calib_fit [--model pwl|poly] [--shift S] [--degree D] [--reject K] [-o 输出.h] 抓包.txt...\n"
+        "  --model   写入头文件的模型 (默认 pwl)\n"
+        "  --shift   表节点间距 2^S 个码 (默认 7 -> 33 点)\n"
+        "  --degree  多项式阶数 (默认 3)\n"
+        "  --reject  剔除阈值 K 倍 MAD (默认 3.0)\n"
+        "  --selftest 用合成 NTC 曲线核对整数表的取整和多项式范围外夹边界\n");
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--model" && i + 1 < argc) opt.model = argv[++i];
+        else if (a == "--shift" && i + 1 < argc) opt.shift = std::atoi(argv[++i]);
+        else if (a == "--degree" && i + 1 < argc) opt.degree = std::atoi(argv[++i]);
+        else if (a == "--reject" && i + 1 < argc) opt.reject_k = std::atof(argv[++i]);
+        else if (a == "-o" && i + 1 < argc) opt.out = argv[++i];
+        else if (a == "--selftest") opt.selftest = true;
+        else if (a.size() > 1 && a[0] == '-') { Usage(); return 2; }
+        else opt.files.push_back(a);
+    }
+    if (opt.selftest && opt.shift >= 1 && opt.shift <= 11) return Self_Test(opt);
+    if (opt.files.empty() || (opt.model != "pwl" && opt.model != "poly") ||
+        opt.shift < 1 || opt.shift > 11 || opt.degree < 1 || opt.degree > 8) {
+        Usage();
+        return 2;
+    }
+
+    std::vector<Point> pts;
+    for (const std::string& path : opt.files) {
+        std::ifstream in(path);
+        if (!in) {
+            std::fprintf(stderr, "打不开 %s\n", path.c_str());
+            return 1;
+        }
+        std::string line;
+        ReportLine r;
+        while (std::getline(in, line)) {
+            if (parse_report_line(line, &r)) pts.push_back({(double)r.adc, r.temp_c});
+        }
+    }
+    std::printf("读入 %zu 对 (ADC, 温度)\n", pts.size());
+    if (pts.size() < 4) {
+        std::fprintf(stderr, "数据太少\n");
+        return 1;
+    }
+
+    PwlModel pwl;
+    FitReport pwl_rep;
+    std::vector<Point> pwl_kept, poly_kept;
+    bool pwl_ok = Robust_Fit(pts, opt.reject_k,
+        [&](const std::vector<Point>& p) { return Fit_Pwl(p, opt.shift, &pwl); },
+        [&](double x) { return pwl.eval(x); }, &pwl_rep, &pwl_kept);
+    if (pwl_ok) Print_Report("pwl", pwl_rep);
+    else std::printf("pwl    拟合失败\n");
+
+    PolyModel poly;
+    FitReport poly_rep;
+    bool poly_ok = Robust_Fit(pts, opt.reject_k,
+        [&](const std::vector<Point>& p) { return Fit_Poly(p, opt.degree, &poly); },
+        [&](double x) { return poly.eval(x); }, &poly_rep, &poly_kept);
+    if (poly_ok) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "poly%d", opt.degree);
+        Print_Report(name, poly_rep);
+    } else {
+        std::printf("poly   拟合失败\n");
+    }
+
+    bool use_pwl = (opt.model == "pwl");
+    if (use_pwl ? !pwl_ok : !poly_ok) return 1;
+    std::vector<int> table = use_pwl
+        ? Build_Table(opt.shift, [&](double x) { return pwl.eval(x); })
+        : Build_Table(opt.shift, [&](double x) { return poly.eval(x); });
+
+    // 按固件整数算法复算内点误差 (含取整)
+    const std::vector<Point>& kept = use_pwl ? pwl_kept : poly_kept;
+    double sq = 0.0, mx = 0.0;
+    for (const Point& p : kept) {
+        double e = std::fabs(p.temp - Table_Lookup(table, opt.shift, (int)p.adc) / 10.0);
+        sq += e * e;
+        mx = std::max(mx, e);
+    }
+    std::printf("整数表 %zu 点, 内点 RMS %.3f C, 最大误差 %.3f C\n",
+                table.size(), std::sqrt(sq / kept.size()), mx);
+
+    if (!Write_Header(opt.out, table, opt.shift, opt.model.c_str(), use_pwl ? pwl_rep : poly_rep)) {
+        std::fprintf(stderr, "写不了 %s\n", opt.out.c_str());
+        return 1;
+    }
+    std::printf("已生成 %s\n", opt.out.c_str());
+    return 0;
+}
@@ -0,0 +1,478 @@
+/*
+ * capture_d.cpp
+ * 串口实时抓包守护进程 (多口，921600 波特不丢数)
+ * 功能：
+ * 1. 所有串口非阻塞打开，一个 epoll 线程读，直接 read() 进每口一个大 SPSC 无锁环 (不拷贝)。
+ * 2. 每口一个写盘线程，按对齐块 (默认 64KB) 批量 pwrite，可选 O_DIRECT；
+ *    不满一块时按 --flush 周期把当前块补齐写一次，之后再原位覆盖，退出时 ftruncate 到真实长度。
+ *    所以 .bin 就是原始字节，另有 .idx 记录每次 read() 的偏移和到达时刻 (见 capture_file.hpp)。
+ * 3. 环满时读进丢弃缓冲并计入 overrun，保证内核 tty 缓冲不被堵死；定期打印
+ *    速率、overrun、环最高水位、写盘延迟 p50/p99/max。
+ * 4. --selftest K：自建 K 个 pty，按波特率灌伪随机数据，抓完逐字节核对。
+ *
+ * 编译：g++ -O2 -std=c++17 -pthread -Itools/common tools/capture_d.cpp -o capture_d
+ * 用法：capture_d [--baud 921600] [--ring MB] [--block KB] [--direct] [--flush MS]
+ *                 [--stats S] -o 输出目录 /dev/ttyUSB0 [/dev/ttyUSB1 ...]
+ *       capture_d --selftest 3 [--seconds 5] [--baud 921600] -o /tmp/cap
+ */
+
+#include "capture_file.hpp"
+#include "serial_port.hpp"
+#include "spsc_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ================= 参数 =================
+struct Options {
+    int baud = 921600;
+    size_t ring_bytes = 16u << 20;   // 每口 16MB，921600 波特下可扛约 3 分钟磁盘停顿
+    size_t block_bytes = 64u << 10;
+    bool direct = false;
+    int flush_ms = 200;
+    int stats_s = 10;
+    std::string out_dir = ".";
+    std::vector<std::string> ports;
+    int selftest = 0;                // >0: 自测口数
+    int seconds = 5;
+};
+
+#define IO_ALIGN        4096
+#define INDEX_RING_LEN  (1u << 16)
+#define LAT_BUCKETS     32           // 写盘延迟按 log2(us) 分桶
+
+static std::atomic<bool> g_stop{false};
+
+static void On_Signal(int) { g_stop.store(true); }
+
+// ================= 每口状态 =================
+struct Port {
+    std::string dev;
+    std::string name;                // 输出文件名前缀
+    int fd = -1;
+    bool open = false;
+
+    std::unique_ptr<SpscRing<uint8_t>> data;
+    std::unique_ptr<SpscRing<IndexRecord>> index;
+    std::atomic<bool> reader_done{false};
+    std::thread writer;
+
+    // 读侧统计 (读线程写，统计时读)
+    uint64_t in_total = 0;
+    std::atomic<uint64_t> in_bytes{0};
+    std::atomic<uint64_t> overrun_bytes{0};
+    std::atomic<uint64_t> index_overrun{0};
+    std::atomic<size_t> ring_peak{0};
+
+    // 写侧统计
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> lat_hist[LAT_BUCKETS];
+    std::atomic<uint64_t> lat_max_us{0};
+
+    Port() { for (auto& h : lat_hist) h.store(0); }
+};
+
+// ================= 串口 =================
+static bool Open_Port(Port* p, int baud) {
+    p->fd = open_serial(p->dev, baud, O_NONBLOCK);
+    if (p->fd < 0) return false;
+    p->open = true;
+    return true;
+}
+
+// /dev/pts/3 -> pts_3, /dev/ttyUSB0 -> ttyUSB0
+static std::string Port_Name(const std::string& dev) {
+    std::string s = dev;
+    if (s.compare(0, 5, "/dev/") == 0) s = s.substr(5);
+    std::replace(s.begin(), s.end(), '/', '_');
+    return s;
+}
+
+// ================= 写盘线程 =================
+static void Record_Latency(Port* p, uint64_t ns) {
+    uint64_t us = ns / 1000;
+    int b = 0;
+    while ((1ull << (b + 1)) <= us && b < LAT_BUCKETS - 1) b++;
+    p->lat_hist[b].fetch_add(1, std::memory_order_relaxed);
+    uint64_t old = p->lat_max_us.load(std::memory_order_relaxed);
+    while (us > old && !p->lat_max_us.compare_exchange_weak(old, us)) {}
+}
+
+static bool Pwrite_All(int fd, const uint8_t* buf, size_t len, uint64_t off) {
+    while (len > 0) {
+        ssize_t w = pwrite(fd, buf, len, (off_t)off);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buf += w;
+        len -= (size_t)w;
+        off += (uint64_t)w;
+    }
+    return true;
+}
+
+static void Writer_Main(Port* p, const Options& opt) {
+    std::string bin = opt.out_dir + "/" + p->name + ".bin";
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    int fd = ::open(bin.c_str(), flags | (opt.direct ? O_DIRECT : 0), 0644);
+    if (fd < 0 && opt.direct) {
+        std::fprintf(stderr, "[%s] O_DIRECT 打不开 (%s)，改用普通写\n", p->name.c_str(), std::strerror(errno));
+        fd = ::open(bin.c_str(), flags, 0644);
+    }
+    FILE* idx = std::fopen(index_path_for(bin).c_str(), "wb");
+    if (fd < 0 || !idx) {
+        std::fprintf(stderr, "[%s] 打不开输出文件: %s\n", p->name.c_str(), std::strerror(errno));
+        g_stop.store(true);
+        if (fd >= 0) ::close(fd);
+        if (idx) std::fclose(idx);
+        return;
+    }
+
+    SpscRing<uint8_t>& ring = *p->data;
+    const size_t block = opt.block_bytes;
+    uint64_t file_off = 0;          // 已完整落盘的字节 (块对齐)
+    size_t flushed_partial = 0;     // 当前块已按补齐方式写过多少有效字节
+    uint64_t last_flush = monotonic_ns();
+    const uint64_t flush_ns = (uint64_t)opt.flush_ms * 1000000ull;
+
+    for (;;) {
+        bool done = p->reader_done.load(std::memory_order_acquire);
+        size_t avail = ring.readable();
+        bool worked = false;
+
+        // a. 整块写出 (环容量是块的整数倍且 tail 块对齐，所以一段连续区不会跨块绕回)
+        if (avail >= block) {
+            size_t pos = ring.read_pos();
+            size_t to_end = ring.capacity() - (pos & (ring.capacity() - 1));
+            size_t len = std::min(avail / block * block, to_end);
+            uint64_t t0 = monotonic_ns();
+            if (!Pwrite_All(fd, ring.at(pos), len, file_off)) {
+                std::fprintf(stderr, "[%s] 写盘失败: %s\n", p->name.c_str(), std::strerror(errno));
+                g_stop.store(true);
+                break;
+            }
+            Record_Latency(p, monotonic_ns() - t0);
+            ring.commit_read(len);
+            file_off += len;
+            flushed_partial = 0;
+            p->written.store(file_off, std::memory_order_relaxed);
+            worked = true;
+            avail -= len;
+        }
+
+        // b. 索引
+        IndexRecord rec;
+        while (p->index->pop(&rec)) {
+            std::fwrite(&rec, sizeof(rec), 1, idx);
+            worked = true;
+        }
+
+        // c. 不满一块：按周期补齐写一次，保证落盘滞后不超过 flush 周期
+        uint64_t now = monotonic_ns();
+        if (avail < block && avail != flushed_partial && (done || now - last_flush >= flush_ns)) {
+            uint64_t t0 = monotonic_ns();
+            if (!Pwrite_All(fd, ring.at(ring.read_pos()), block, file_off)) {
+                std::fprintf(stderr, "[%s] 写盘失败: %s\n", p->name.c_str(), std::strerror(errno));
+                g_stop.store(true);
+                break;
+            }
+            Record_Latency(p, monotonic_ns() - t0);
+            flushed_partial = avail;
+            p->written.store(file_off + avail, std::memory_order_relaxed);
+            std::fflush(idx);
+            last_flush = now;
+        }
+
+        if (done && ring.readable() == flushed_partial && p->index->readable() == 0) {
+            if (ftruncate(fd, (off_t)(file_off + flushed_partial)) != 0) {
+                std::fprintf(stderr, "[%s] ftruncate 失败: %s\n", p->name.c_str(), std::strerror(errno));
+            }
+            break;
+        }
+        if (!worked) usleep(2000);
+    }
+    ::close(fd);
+    std::fclose(idx);
+}
+
+// ================= 读线程 (epoll) =================
+static void Read_Port(Port* p, uint8_t* scratch, size_t scratch_len) {
+    for (;;) {
+        size_t n;
+        uint8_t* dst = p->data->write_span(&n);
+        bool dropping = (n == 0);
+        if (dropping) {
+            dst = scratch;
+            n = scratch_len;
+        }
+        ssize_t r = ::read(p->fd, dst, n);
+        if (r > 0) {
+            if (dropping) {
+                p->overrun_bytes.fetch_add((uint64_t)r, std::memory_order_relaxed);
+                continue;
+            }
+            if (!p->index->push({p->in_total, realtime_ns()})) {
+                p->index_overrun.fetch_add(1, std::memory_order_relaxed);
+            }
+            p->data->commit_write((size_t)r);
+            p->in_total += (uint64_t)r;
+            p->in_bytes.store(p->in_total, std::memory_order_relaxed);
+            size_t fill = p->data->readable();
+            if (fill > p->ring_peak.load(std::memory_order_relaxed)) p->ring_peak.store(fill);
+            continue;
+        }
+        if (r < 0 && (errno == EAGAIN || errno == EINTR)) return;
+        // r == 0 或 EIO (pty 主端关闭 / USB 拔出)
+        p->open = false;
+        return;
+    }
+}
+
+static uint64_t Latency_Pct(const Port* p, double q) {
+    uint64_t total = 0;
+    for (const auto& h : p->lat_hist) total += h.load();
+    if (total == 0) return 0;
+    uint64_t want = (uint64_t)(q * (double)total), acc = 0;
+    for (int b = 0; b < LAT_BUCKETS; b++) {
+        acc += p->lat_hist[b].load();
+        if (acc > want) return 1ull << (b + 1);   // 桶上界
+    }
+    return 1ull << LAT_BUCKETS;
+}
+
+static void Print_Stats(std::vector<std::unique_ptr<Port>>& ports, double dt, std::vector<uint64_t>& last_in) {
+    for (size_t i = 0; i < ports.size(); i++) {
+        Port* p = ports[i].get();
+        uint64_t in = p->in_bytes.load();
+        std::fprintf(stderr,
+            "[%s] %.1f KB/s 收 %llu 写 %llu overrun %llu idx_overrun %llu 环峰值 %.1f%% 写盘 p50<%lluus p99<%lluus max %lluus\n",
+            p->name.c_str(), (double)(in - last_in[i]) / 1024.0 / dt,
+            (unsigned long long)in, (unsigned long long)p->written.load(),
+            (unsigned long long)p->overrun_bytes.load(), (unsigned long long)p->index_overrun.load(),
+            100.0 * (double)p->ring_peak.load() / (double)p->data->capacity(),
+            (unsigned long long)Latency_Pct(p, 0.50), (unsigned long long)Latency_Pct(p, 0.99),
+            (unsigned long long)p->lat_max_us.load());
+        last_in[i] = in;
+    }
+}
+
+static int Run_Capture(std::vector<std::unique_ptr<Port>>& ports, const Options& opt) {
+    int ep = epoll_create1(0);
+    if (ep < 0) {
+        std::perror("epoll_create1");
+        return 1;
+    }
+    for (size_t i = 0; i < ports.size(); i++) {
+        Port* p = ports[i].get();
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        epoll_ctl(ep, EPOLL_CTL_ADD, p->fd, &ev);
+        p->writer = std::thread(Writer_Main, p, std::cref(opt));
+    }
+
+    std::vector<uint8_t> scratch(64 * 1024);
+    std::vector<uint64_t> last_in(ports.size(), 0);
+    uint64_t last_stats = monotonic_ns();
+    size_t open_count = ports.size();
+    struct epoll_event evs[16];
+
+    while (!g_stop.load() && open_count > 0) {
+        int n = epoll_wait(ep, evs, 16, 100);
+        for (int k = 0; k < n; k++) {
+            Port* p = ports[evs[k].data.u64].get();
+            if (!p->open) continue;
+            Read_Port(p, scratch.data(), scratch.size());
+            if (!p->open) {
+                epoll_ctl(ep, EPOLL_CTL_DEL, p->fd, nullptr);
+                p->reader_done.store(true, std::memory_order_release);
+                open_count--;
+                std::fprintf(stderr, "[%s] 端口关闭\n", p->name.c_str());
+            }
+        }
+        uint64_t now = monotonic_ns();
+        if (opt.stats_s > 0 && now - last_stats >= (uint64_t)opt.stats_s * 1000000000ull) {
+            Print_Stats(ports, (double)(now - last_stats) / 1e9, last_in);
+            last_stats = now;
+        }
+    }
+
+    uint64_t end = monotonic_ns();   // 收完最后一批的时刻，等写盘线程的时间不算进速率
+    for (auto& p : ports) p->reader_done.store(true, std::memory_order_release);
+    for (auto& p : ports) p->writer.join();
+    Print_Stats(ports, (double)(end - last_stats) / 1e9, last_in);
+    ::close(ep);
+
+    int rc = 0;
+    for (auto& p : ports) {
+        ::close(p->fd);
+        if (p->overrun_bytes.load() || p->index_overrun.load()) rc = 3;
+    }
+    return rc;
+}
+
+// ================= pty 自测 =================
+static uint8_t Pattern_Byte(std::mt19937& rng) { return (uint8_t)(rng() & 0xFF); }
+
+static void Feeder_Main(int master, uint32_t seed, int baud, int seconds, uint64_t* sent) {
+    std::mt19937 rng(seed);
+    const size_t chunk = 64;
+    const uint64_t bytes_per_s = (uint64_t)baud / 10;
+    const uint64_t period_ns = 1000000000ull * chunk / bytes_per_s;
+    uint8_t buf[chunk];
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    uint64_t end = monotonic_ns() + (uint64_t)seconds * 1000000000ull;
+    *sent = 0;
+    while (monotonic_ns() < end) {
+        for (size_t i = 0; i < chunk; i++) buf[i] = Pattern_Byte(rng);
+        size_t off = 0;
+        while (off < chunk) {
+            ssize_t w = ::write(master, buf + off, chunk - off);
+            if (w < 0) {
+                if (errno == EAGAIN || errno == EINTR) { usleep(100); continue; }
+                return;
+            }
+            off += (size_t)w;
+        }
+        *sent += chunk;
+        next.tv_nsec += (long)period_ns;
+        while (next.tv_nsec >= 1000000000L) { next.tv_nsec -= 1000000000L; next.tv_sec++; }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+    }
+    // 等读端排空再关主端，否则 pty 缓冲里剩余数据会随 EIO 丢掉
+    usleep(300000);
+}
+
+static int Run_Selftest(Options opt) {
+    std::vector<int> masters;
+    std::vector<std::unique_ptr<Port>> ports;
+    for (int i = 0; i < opt.selftest; i++) {
+        std::string slave;
+        int m = open_pty_master(&slave);
+        if (m < 0) {
+            std::perror("posix_openpt");
+            return 1;
+        }
+        masters.push_back(m);
+        auto p = std::make_unique<Port>();
+        p->dev = slave;
+        p->name = "selftest" + std::to_string(i);
+        p->data = std::make_unique<SpscRing<uint8_t>>(opt.ring_bytes, IO_ALIGN);
+        p->index = std::make_unique<SpscRing<IndexRecord>>(INDEX_RING_LEN);
+        if (!Open_Port(p.get(), opt.baud)) {
+            std::perror(p->dev.c_str());
+            return 1;
+        }
+        ports.push_back(std::move(p));
+    }
+
+    std::vector<uint64_t> sent(masters.size(), 0);
+    std::vector<std::thread> feeders;
+    for (size_t i = 0; i < masters.size(); i++) {
+        feeders.emplace_back([&, i] {
+            Feeder_Main(masters[i], 1000 + (uint32_t)i, opt.baud, opt.seconds, &sent[i]);
+            ::close(masters[i]);
+        });
+    }
+    int rc = Run_Capture(ports, opt);
+    for (auto& t : feeders) t.join();
+
+    // 逐字节核对
+    for (size_t i = 0; i < ports.size(); i++) {
+        std::string bin = opt.out_dir + "/" + ports[i]->name + ".bin";
+        FILE* f = std::fopen(bin.c_str(), "rb");
+        std::mt19937 rng(1000 + (uint32_t)i);
+        uint64_t n = 0, bad = 0;
+        int c;
+        while (f && (c = std::fgetc(f)) != EOF) {
+            if ((uint8_t)c != Pattern_Byte(rng)) bad++;
+            n++;
+        }
+        if (f) std::fclose(f);
+        std::vector<IndexRecord> idx;
+        load_index(index_path_for(bin), &idx);
+        bool mono = true;
+        for (size_t k = 1; k < idx.size(); k++) {
+            if (idx[k].offset <= idx[k - 1].offset || idx[k].t_ns < idx[k - 1].t_ns) mono = false;
+        }
+        bool ok = (n == sent[i] && bad == 0 && mono);
+        std::printf("%s: 发 %llu 收 %llu 错 %llu 索引 %zu 条%s -> %s\n", ports[i]->name.c_str(),
+                    (unsigned long long)sent[i], (unsigned long long)n, (unsigned long long)bad,
+                    idx.size(), mono ? "" : " (不单调)", ok ? "PASS" : "FAIL");
+        if (!ok) rc = 1;
+    }
+    return rc;
+}
+
+// ================= 主函数 =================
+static void Usage(void) {
+    std::fprintf(stderr,
+        "用法: capture_d [--baud B] [--ring MB] [--block KB] [--direct] [--flush MS] [--stats S]\n"
+        "                -o 输出目录 串口...\n"
+        "       capture_d --selftest K [--seconds S] [--baud B] -o 输出目录\n");
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--baud" && i + 1 < argc) opt.baud = std::atoi(argv[++i]);
+        else if (a == "--ring" && i + 1 < argc) opt.ring_bytes = (size_t)std::atoll(argv[++i]) << 20;
+        else if (a == "--block" && i + 1 < argc) opt.block_bytes = (size_t)std::atoll(argv[++i]) << 10;
+        else if (a == "--direct") opt.direct = true;
+        else if (a == "--flush" && i + 1 < argc) opt.flush_ms = std::atoi(argv[++i]);
+        else if (a == "--stats" && i + 1 < argc) opt.stats_s = std::atoi(argv[++i]);
+        else if (a == "-o" && i + 1 < argc) opt.out_dir = argv[++i];
+        else if (a == "--selftest" && i + 1 < argc) opt.selftest = std::atoi(argv[++i]);
+        else if (a == "--seconds" && i + 1 < argc) opt.seconds = std::atoi(argv[++i]);
+        else if (a.size() > 1 && a[0] == '-') { Usage(); return 2; }
+        else opt.ports.push_back(a);
+    }
+    if (opt.block_bytes < IO_ALIGN || (opt.block_bytes & (opt.block_bytes - 1)) != 0 ||
+        opt.ring_bytes < 2 * opt.block_bytes || (opt.selftest <= 0 && opt.ports.empty())) {
+        Usage();
+        return 2;
+    }
+    mkdir(opt.out_dir.c_str(), 0755);
+
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = On_Signal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    if (opt.selftest > 0) return Run_Selftest(opt);
+
+    std::vector<std::unique_ptr<Port>> ports;
+    for (const std::string& dev : opt.ports) {
+        auto p = std::make_unique<Port>();
+        p->dev = dev;
+        p->name = Port_Name(dev);
+        // 环容量向上取 2 的幂，块大小也是 2 的幂 (4K 的倍数)，保证容量是块的整数倍
+        p->data = std::make_unique<SpscRing<uint8_t>>(opt.ring_bytes, IO_ALIGN);
+        p->index = std::make_unique<SpscRing<IndexRecord>>(INDEX_RING_LEN);
+        if (!Open_Port(p.get(), opt.baud)) {
+            std::fprintf(stderr, "打不开 %s: %s\n", dev.c_str(), std::strerror(errno));
+            return 1;
+        }
+        ports.push_back(std::move(p));
+    }
+    return Run_Capture(ports, opt);
+}
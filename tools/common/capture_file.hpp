@@ -0,0 +1,104 @@
+/*
+ * capture_file.hpp
+ * 上位机工具共用：capture_d 抓包文件格式
+ *   xxx.bin  串口原始字节，原样保存 (jrzx_scan 可以直接扫)
+ *   xxx.idx  时间索引，每次 read() 一条 IndexRecord：这批字节在 .bin 中的起始偏移 + 到达时刻
+ * 到达时刻用 CLOCK_REALTIME 纳秒，多台设备的抓包可以直接按绝对时间对齐。
+ */
+#ifndef CAPTURE_FILE_HPP
+#define CAPTURE_FILE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <time.h>
+
+#include "mapped_file.hpp"
+
+struct IndexRecord {
+    uint64_t offset;   // .bin 中的字节偏移
+    uint64_t t_ns;     // CLOCK_REALTIME 纳秒
+};
+static_assert(sizeof(IndexRecord) == 16, "IndexRecord 必须紧凑");
+
+inline uint64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+inline uint64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// xxx.bin -> xxx.idx
+inline std::string index_path_for(const std::string& bin_path) {
+    std::string p = bin_path;
+    if (p.size() > 4 && p.compare(p.size() - 4, 4, ".bin") == 0) p.resize(p.size() - 4);
+    return p + ".idx";
+}
+
+// 读整个索引 (每条 16 字节，一天 921600 波特的抓包也就几十 MB)
+inline bool load_index(const std::string& path, std::vector<IndexRecord>* out) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    IndexRecord r;
+    while (std::fread(&r, sizeof(r), 1, f) == 1) out->push_back(r);
+    std::fclose(f);
+    return true;
+}
+
+// 字节偏移 -> 到达时刻 (取该字节所在那批 read() 的时刻)
+inline uint64_t time_at_offset(const std::vector<IndexRecord>& idx, uint64_t off) {
+    size_t lo = 0, hi = idx.size();
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (idx[mid].offset <= off) lo = mid;
+        else hi = mid;
+    }
+    return idx.empty() ? 0 : idx[lo].t_ns;
+}
+
+// 顺序读取 .bin + .idx：每次给出一批 read() 的字节和到达时刻。
+// .bin 走 mmap，.idx 流式读，内存不随抓包长度增长。
+class CaptureReader {
+public:
+    CaptureReader() = default;
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+    ~CaptureReader() { if (idx_) std::fclose(idx_); }
+
+    bool open(const std::string& bin) {
+        if (!bin_.open(bin)) return false;
+        idx_ = std::fopen(index_path_for(bin).c_str(), "rb");
+        if (!idx_) return false;
+        have_ = std::fread(&cur_, sizeof(cur_), 1, idx_) == 1;
+        return true;
+    }
+
+    bool next(uint64_t* t_ns, const uint8_t** data, size_t* len) {
+        if (!have_) return false;
+        IndexRecord nxt;
+        bool more = std::fread(&nxt, sizeof(nxt), 1, idx_) == 1;
+        uint64_t end = more ? nxt.offset : (uint64_t)bin_.size();
+        if (cur_.offset > end || end > bin_.size()) return false;
+        *t_ns = cur_.t_ns;
+        *data = bin_.data() + cur_.offset;
+        *len = (size_t)(end - cur_.offset);
+        cur_ = nxt;
+        have_ = more;
+        return true;
+    }
+
+private:
+    MappedFile bin_;
+    FILE* idx_ = nullptr;
+    IndexRecord cur_{};
+    bool have_ = false;
+};
+
+#endif /* CAPTURE_FILE_HPP */
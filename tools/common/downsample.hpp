@@ -0,0 +1,120 @@
+/*
+ * downsample.hpp
+ * 上位机工具共用：长序列画图降采样
+ * 1. LTTB (largest-triangle-three-buckets)：输出 n 点，保留视觉形状。
+ * 2. min/max：每桶保留最小、最大两点 (按时间先后)，尖峰一个不丢。
+ * 两者都按桶区间切给多个线程并行；输入是只读数组 (通常直接指向 mmap 的列文件)。
+ *
+ * LTTB 本身是串行的 (每桶依赖上一桶选中的点)。并行时每段的第一个桶用上一桶的质心
+ * 代替 "上一桶选中的点"，与串行结果只在段边界的个别点上可能不同，肉眼看不出。
+ */
+#ifndef DOWNSAMPLE_HPP
+#define DOWNSAMPLE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace ds {
+
+struct Point {
+    double x, y;
+};
+
+// 把 [begin, end) 按桶分给 threads 个线程，fn(bucket_lo, bucket_hi)
+template <typename Fn>
+inline void parallel_buckets(size_t begin, size_t end, unsigned threads, Fn fn) {
+    size_t n = end - begin;
+    if (threads <= 1 || n < 2 * (size_t)threads) {
+        fn(begin, end);
+        return;
+    }
+    std::vector<std::thread> pool;
+    size_t per = (n + threads - 1) / threads;
+    for (size_t lo = begin; lo < end; lo += per) {
+        size_t hi = std::min(end, lo + per);
+        pool.emplace_back(fn, lo, hi);
+    }
+    for (auto& t : pool) t.join();
+}
+
+// LTTB：x/y 长度 n，输出 out_n 点 (out_n >= 3，且 < n，否则原样拷贝)
+inline std::vector<Point> lttb(const double* x, const double* y, size_t n, size_t out_n, unsigned threads) {
+    std::vector<Point> out;
+    if (out_n >= n || out_n < 3) {
+        out.reserve(n);
+        for (size_t i = 0; i < n; i++) out.push_back({x[i], y[i]});
+        return out;
+    }
+    out.resize(out_n);
+    out[0] = {x[0], y[0]};
+    out[out_n - 1] = {x[n - 1], y[n - 1]};
+
+    // 中间 n-2 点分成 out_n-2 个桶；桶 b 覆盖 [start(b), start(b+1))
+    const double every = (double)(n - 2) / (double)(out_n - 2);
+    auto start = [&](size_t b) { return (size_t)std::floor((double)b * every) + 1; };
+    auto centroid = [&](size_t lo, size_t hi) {
+        double ax = 0.0, ay = 0.0;
+        for (size_t i = lo; i < hi; i++) { ax += x[i]; ay += y[i]; }
+        double m = (double)(hi - lo);
+        return Point{ax / m, ay / m};
+    };
+
+    parallel_buckets(0, out_n - 2, threads, [&](size_t b_lo, size_t b_hi) {
+        Point a = (b_lo == 0) ? out[0] : centroid(start(b_lo - 1), start(b_lo));
+        for (size_t b = b_lo; b < b_hi; b++) {
+            size_t lo = start(b), hi = std::min(start(b + 1), n - 1);
+            // 下一桶的质心 (最后一个桶用终点)
+            Point c = (b + 1 < out_n - 2) ? centroid(hi, std::min(start(b + 2), n - 1)) : out[out_n - 1];
+            double best = -1.0;
+            size_t pick = lo;
+            for (size_t i = lo; i < hi; i++) {
+                double area = std::fabs((a.x - c.x) * (y[i] - a.y) - (a.x - x[i]) * (c.y - a.y));
+                if (area > best) { best = area; pick = i; }
+            }
+            out[b + 1] = {x[pick], y[pick]};
+            a = out[b + 1];
+        }
+    });
+    return out;
+}
+
+// min/max：buckets 个等点数桶，每桶按出现先后输出 min、max (相同时只输出一点)
+inline std::vector<Point> minmax(const double* x, const double* y, size_t n, size_t buckets, unsigned threads) {
+    std::vector<Point> out;
+    if (buckets == 0 || 2 * buckets >= n) {
+        out.reserve(n);
+        for (size_t i = 0; i < n; i++) out.push_back({x[i], y[i]});
+        return out;
+    }
+    // 每桶固定 2 个输出槽，事后压掉空槽，线程间不用同步
+    std::vector<Point> slots(2 * buckets);
+    std::vector<unsigned char> used(2 * buckets, 0);
+    const double every = (double)n / (double)buckets;
+    parallel_buckets(0, buckets, threads, [&](size_t b_lo, size_t b_hi) {
+        for (size_t b = b_lo; b < b_hi; b++) {
+            size_t lo = (size_t)((double)b * every), hi = std::min(n, (size_t)((double)(b + 1) * every));
+            if (lo >= hi) continue;
+            size_t imin = lo, imax = lo;
+            for (size_t i = lo + 1; i < hi; i++) {
+                if (y[i] < y[imin]) imin = i;
+                if (y[i] > y[imax]) imax = i;
+            }
+            size_t first = std::min(imin, imax), second = std::max(imin, imax);
+            slots[2 * b] = {x[first], y[first]};
+            used[2 * b] = 1;
+            if (second != first) {
+                slots[2 * b + 1] = {x[second], y[second]};
+                used[2 * b + 1] = 1;
+            }
+        }
+    });
+    for (size_t i = 0; i < slots.size(); i++) if (used[i]) out.push_back(slots[i]);
+    return out;
+}
+
+} // namespace ds
+
+#endif /* DOWNSAMPLE_HPP */
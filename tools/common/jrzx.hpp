@@ -0,0 +1,222 @@
+/*
+ * jrzx.hpp
+ * 上位机工具共用：JRZX 协议帧定义与二进制帧扫描
+ * 协议格式 (见 JRZX_HC通信协议.docx)：
+ *   0xFC | Length(2B, 小端, 全长) | CMD | 内容... | XOR(含协议头)
+ * 扫描器：
+ *   先找候选帧头 0xFC (SSE2 每次16字节 / AVX2 每次32字节 / 标量回退)，
+ *   再校验长度和 XOR，通过后整帧跳过。
+ */
+#ifndef JRZX_HPP
+#define JRZX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JRZX_HAVE_X86 1
+#else
+#define JRZX_HAVE_X86 0
+#endif
+
+namespace jrzx {
+
+// ================= 协议常量 =================
+constexpr uint8_t  HEAD        = 0xFC;
+constexpr size_t   MIN_LEN     = 5;     // FC L L CMD XOR
+constexpr size_t   MAX_LEN     = 512;   // IAP 数据包最大 5+2+255，留余量
+constexpr uint8_t  CMD_TEMP    = 0x01;  // 温度转换上传
+constexpr uint8_t  CMD_LED     = 0x02;  // 状态灯控制
+constexpr uint8_t  CMD_ONLINE  = 0x31;  // 查询在线
+constexpr uint8_t  CMD_IAP_VER = 0xE0;  // IAP: 查询版本
+constexpr uint8_t  CMD_IAP_INF = 0xE1;  // IAP: 固件信息
+constexpr uint8_t  CMD_IAP_DAT = 0xE2;  // IAP: 固件数据
+constexpr uint8_t  CMD_IAP_END = 0xE3;  // IAP: 停止
+constexpr uint8_t  CMD_TRACE   = 0x70;  // 私有：固件事件跟踪导出 (trace.c)
+constexpr uint8_t  CMD_PROFILE = 0x71;  // 私有：固件性能分析表 (profile.c)
+constexpr uint8_t  CMD_DIAG    = 0x72;  // 私有：固件诊断信息 (栈高水位、收帧计数)
+constexpr uint8_t  CMD_REPORT  = 0x73;  // 私有：固件二进制报告 (MONITOR_FORMAT_FRAME)
+constexpr uint8_t  CMD_HIST    = 0x74;  // 私有：固件 ADC 直方图 (histogram.c)
+constexpr uint8_t  CMD_UNSUP   = 0xFF;  // 不支持的指令
+
+// 校验或：从 p[0] 开始连续 n 字节
+inline uint8_t xor_sum(const uint8_t* p, size_t n) {
+    uint8_t x = 0;
+    for (size_t i = 0; i < n; i++) x ^= p[i];
+    return x;
+}
+
+// 组帧：写入 out (容量至少 payload_len + 5)，返回帧长
+inline size_t build_frame(uint8_t* out, uint8_t cmd, const uint8_t* payload, size_t payload_len) {
+    size_t len = payload_len + MIN_LEN;
+    out[0] = HEAD;
+    out[1] = (uint8_t)(len & 0xFF);
+    out[2] = (uint8_t)(len >> 8);
+    out[3] = cmd;
+    if (payload_len) std::memcpy(out + 4, payload, payload_len);
+    out[len - 1] = xor_sum(out, len - 1);
+    return len;
+}
+
+// 一帧的位置信息 (指向原始缓冲区，不拷贝)
+struct Frame {
+    size_t         offset;  // 帧头在缓冲区中的偏移
+    size_t         len;     // 帧全长
+    uint8_t        cmd;
+    const uint8_t* data;    // 指向帧头
+};
+
+// 0x01 应答帧中的温度 (0.1度)，长度不够返回 false
+inline bool frame_temp_deci(const Frame& f, int* deci) {
+    if (f.cmd != CMD_TEMP || f.len < 7) return false;
+    *deci = (int)(f.data[4] | (f.data[5] << 8));
+    return true;
+}
+
+// 在 i 处校验一帧，成功返回帧长，失败返回 0
+inline size_t validate_at(const uint8_t* p, size_t n, size_t i) {
+    if (n - i < MIN_LEN) return 0;
+    size_t len = (size_t)p[i + 1] | ((size_t)p[i + 2] << 8);
+    if (len < MIN_LEN || len > MAX_LEN || len > n - i) return 0;
+    if (xor_sum(p + i, len - 1) != p[i + len - 1]) return 0;
+    return len;
+}
+
+// ================= 候选帧头查找 =================
+enum class Impl { Auto, Scalar, SSE2, AVX2 };
+
+inline const char* impl_name(Impl impl) {
+    switch (impl) {
+        case Impl::Scalar: return "scalar";
+        case Impl::SSE2:   return "sse2";
+        case Impl::AVX2:   return "avx2";
+        default:           return "auto";
+    }
+}
+
+inline size_t find_head_scalar(const uint8_t* p, size_t from, size_t n) {
+    const void* hit = std::memchr(p + from, HEAD, n - from);
+    return hit ? (size_t)((const uint8_t*)hit - p) : n;
+}
+
+#if JRZX_HAVE_X86
+inline size_t find_head_sse2(const uint8_t* p, size_t from, size_t n) {
+    const __m128i head = _mm_set1_epi8((char)HEAD);
+    size_t i = from;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, head));
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    for (; i < n; i++) if (p[i] == HEAD) return i;
+    return n;
+}
+
+__attribute__((target("avx2")))
+inline size_t find_head_avx2(const uint8_t* p, size_t from, size_t n) {
+    const __m256i head = _mm256_set1_epi8((char)HEAD);
+    size_t i = from;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, head));
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    for (; i < n; i++) if (p[i] == HEAD) return i;
+    return n;
+}
+#endif
+
+// Auto 按 CPU 能力选择
+inline Impl resolve_impl(Impl impl) {
+#if JRZX_HAVE_X86
+    if (impl == Impl::Auto) {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? Impl::AVX2 : Impl::SSE2;
+    }
+    if (impl == Impl::AVX2) {
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("avx2")) return Impl::SSE2;
+    }
+    return impl;
+#else
+    return Impl::Scalar;
+#endif
+}
+
+// ================= 帧扫描 =================
+// 对每个有效帧调用 on_frame(const Frame&)，返回有效帧数。
+// 校验失败的候选只前进 1 字节，保证帧内出现 0xFC 时也能重新同步。
+template <typename FindHead, typename OnFrame>
+inline size_t scan_with(const uint8_t* p, size_t n, FindHead find, OnFrame&& on_frame) {
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos < n) {
+        size_t i = find(p, pos, n);
+        if (i >= n) break;
+        size_t len = validate_at(p, n, i);
+        if (len) {
+            Frame f{i, len, p[i + 3], p + i};
+            on_frame(f);
+            count++;
+            pos = i + len;
+        } else {
+            pos = i + 1;
+        }
+    }
+    return count;
+}
+
+template <typename OnFrame>
+inline size_t scan_frames(const uint8_t* p, size_t n, Impl impl, OnFrame&& on_frame) {
+    switch (resolve_impl(impl)) {
+#if JRZX_HAVE_X86
+        case Impl::AVX2: return scan_with(p, n, find_head_avx2, on_frame);
+        case Impl::SSE2: return scan_with(p, n, find_head_sse2, on_frame);
+#endif
+        default:         return scan_with(p, n, find_head_scalar, on_frame);
+    }
+}
+
+// ================= 逐字节状态机 (对照基准) =================
+// 早期固件 HAL_UART_RxCpltCallback 的解析方式：每字节进一次 switch，
+// 只识别 FC 0A 00 01 + 6字节数据。用于 --bench 对比。
+class ByteStateMachine {
+public:
+    template <typename OnTemp>
+    void feed(uint8_t b, OnTemp&& on_temp) {
+        switch (state_) {
+            case WAIT_FC:
+                if (b == 0xFC) state_ = CHECK_LEN;
+                break;
+            case CHECK_LEN:
+                state_ = (b == 0x0A) ? CHECK_ZERO : WAIT_FC;
+                break;
+            case CHECK_ZERO:
+                state_ = (b == 0x00) ? CHECK_STATUS : WAIT_FC;
+                break;
+            case CHECK_STATUS:
+                if (b == 0x01) { state_ = READ_DATA; idx_ = 0; }
+                else state_ = WAIT_FC;
+                break;
+            case READ_DATA:
+                buf_[idx_++] = b;
+                if (idx_ >= 6) {
+                    on_temp((int)(buf_[0] | (buf_[1] << 8)));
+                    state_ = WAIT_FC;
+                }
+                break;
+        }
+    }
+
+private:
+    enum State { WAIT_FC, CHECK_LEN, CHECK_ZERO, CHECK_STATUS, READ_DATA };
+    State   state_ = WAIT_FC;
+    uint8_t buf_[6] = {0};
+    uint8_t idx_ = 0;
+};
+
+} // namespace jrzx
+
+#endif /* JRZX_HPP */
@@ -0,0 +1,212 @@
+/*
+ * report_line.hpp
+ * 上位机工具共用：解析固件打印的报告行
+ *   [时间s] T:温度 C, ADC:值
+ * 例：[12.25s] T:28.5 C, ADC:2048
+ * 可选尾随字段：M:帧序号 (固件 MONITOR_LATENCY_MARK 模式)
+ *               AS:/TS: 窗口统计 个数/最小/最大/均值/标准差 (固件 MONITOR_STATS 模式，ADC / 温度)
+ *               SUP:上次报告之后被死区压掉的窗口数 (固件 MONITOR_DEADBAND 模式)
+ *               LAG:ADC 相对温度的延迟毫秒/相关系数% (固件 MONITOR_XCORR 模式)
+ *               PT:预测稳态温度 C, TAU:时间常数 ms (固件 MONITOR_PREDICT 模式)
+ *               AL:对齐的 对数/ADC 均值/温度均值/过期个数 (固件 MONITOR_ALIGN 模式)
+ *               DR:拟合帧数/帧周期 us/漂移 ppm/抖动 us/截断帧数 (固件 MONITOR_DRIFT 模式)
+ *               TC:热电偶温度/故障位 (固件 MONITOR_TC 模式，故障位 0 才是有效读数)
+ * 多实例固件行首带 "S编号 "，例：S2 [12.25s] T:28.5 C, ADC:2048
+ * 行前可以有其它前缀 (例如合并工具加的设备标签)，只认 '[' 之后的内容和紧挨着的 S编号。
+ */
+#ifndef REPORT_LINE_HPP
+#define REPORT_LINE_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// 窗口统计，n 为 0 表示没有
+struct WindowStats {
+    long   n = 0;
+    double min = 0.0, max = 0.0, mean = 0.0, sd = 0.0;
+};
+
+struct ReportLine {
+    double t_s = 0.0;      // 相对时间 (秒)
+    double temp_c = 0.0;   // 温度 (度)
+    long   adc = 0;        // ADC 中值
+    long   mark = -1;      // M: 帧序号，没有为 -1
+    int    sensor = 0;     // S 编号 (从 1 起)，单实例固件为 0
+    long   suppressed = -1;  // SUP:，没有为 -1
+    bool   has_lag = false;
+    long   lag_ms = 0;       // LAG: 毫秒，ADC 比温度晚为正
+    int    lag_rho = 0;      // LAG: 相关系数 x100，0 表示固件还没有估计
+    bool   has_predict = false;
+    double pred_c = 0.0;     // PT: 预测稳态温度 (度)
+    long   tau_ms = 0;       // TAU: 时间常数，0 表示固件还没辨识出来
+    bool   has_align = false;
+    long   align_n = 0;      // AL: 对齐的对数，0 表示这个窗口没有
+    double align_adc = 0.0;  // AL: 对齐的 ADC 均值
+    double align_temp_c = 0.0;  // AL: 插值到 ADC 采样时刻的温度均值 (度)
+    long   align_stale = 0;  // AL: 过期个数
+    bool   has_drift = false;
+    long   drift_n = 0;      // DR: 拟合帧数，不到固件的锁定帧数时 ppm 为 0
+    long   period_us = 0;    // DR: 传感器帧周期 (本机 us)
+    double drift_ppm = 0.0;  // DR: 本机时钟相对传感器快多少 ppm
+    long   jitter_us = 0;    // DR: 帧到达抖动
+    long   drift_outliers = 0;  // DR: 被截断或跳过的帧
+    bool   has_tc = false;
+    double tc_c = 0.0;       // TC: 热电偶温度 (度)
+    int    tc_fault = 0;     // TC: 故障位 (1 开路 2 对地短路 4 对电源短路 128 还没读到)
+    bool   has_stats = false;
+    WindowStats adc_stats;   // AS:
+    WindowStats temp_stats;  // TS:
+};
+
+// 在 s 中查找 key，返回其后的数值起点，找不到返回 nullptr
+inline const char* report_field(const char* s, const char* key) {
+    const char* p = std::strstr(s, key);
+    return p ? p + std::strlen(key) : nullptr;
+}
+
+// "n/min/max/mean/sd"
+inline bool parse_window_stats(const char* p, WindowStats* out) {
+    char* end = nullptr;
+    out->n = std::strtol(p, &end, 10);
+    if (end == p) return false;
+    double* v[4] = {&out->min, &out->max, &out->mean, &out->sd};
+    for (double* d : v) {
+        if (*end != '/') return false;
+        p = end + 1;
+        *d = std::strtod(p, &end);
+        if (end == p) return false;
+    }
+    return true;
+}
+
+// 解析成功返回 true；提示行 ([System Ready]、-> START 等) 返回 false
+inline bool parse_report_line(const char* s, ReportLine* out) {
+    const char* lb = std::strchr(s, '[');
+    if (!lb) return false;
+    char* end = nullptr;
+    double t = std::strtod(lb + 1, &end);
+    if (end == lb + 1 || *end != 's') return false;
+
+    const char* pt = report_field(end, "T:");
+    const char* pa = report_field(end, "ADC:");
+    if (!pt || !pa) return false;
+    char* tend = nullptr;
+    double temp = std::strtod(pt, &tend);
+    if (tend == pt) return false;
+    char* aend = nullptr;
+    long adc = std::strtol(pa, &aend, 10);
+    if (aend == pa) return false;
+
+    out->t_s = t;
+    out->temp_c = temp;
+    out->adc = adc;
+    out->mark = -1;
+    out->sensor = 0;
+    // '[' 前面紧挨着 "S编号 "
+    const char* q = lb;
+    while (q > s && q[-1] == ' ') q--;
+    const char* d = q;
+    while (d > s && d[-1] >= '0' && d[-1] <= '9') d--;
+    if (d < q && d > s && d[-1] == 'S') out->sensor = std::atoi(d);
+    const char* pm = report_field(aend, "M:");
+    if (pm) {
+        char* mend = nullptr;
+        long m = std::strtol(pm, &mend, 10);
+        if (mend != pm) out->mark = m;
+    }
+    out->suppressed = -1;
+    const char* ps = report_field(aend, "SUP:");
+    if (ps) {
+        char* send = nullptr;
+        long v = std::strtol(ps, &send, 10);
+        if (send != ps) out->suppressed = v;
+    }
+    out->has_lag = false;
+    const char* pl = report_field(aend, "LAG:");
+    if (pl) {
+        char* lend = nullptr;
+        long v = std::strtol(pl, &lend, 10);
+        if (lend != pl && *lend == '/') {
+            out->lag_ms = v;
+            out->lag_rho = (int)std::strtol(lend + 1, nullptr, 10);
+            out->has_lag = true;
+        }
+    }
+    out->has_predict = false;
+    const char* pp = report_field(aend, "PT:");
+    const char* pu = report_field(aend, "TAU:");
+    if (pp && pu) {
+        char* pend = nullptr;
+        out->pred_c = std::strtod(pp, &pend);
+        out->tau_ms = std::strtol(pu, nullptr, 10);
+        out->has_predict = pend != pp;
+    }
+    out->has_align = false;
+    const char* pal = report_field(aend, "AL:");
+    if (pal) {
+        char* e1 = nullptr;
+        char* e2 = nullptr;
+        char* e3 = nullptr;
+        out->align_n = std::strtol(pal, &e1, 10);
+        if (e1 != pal && *e1 == '/') out->align_adc = std::strtod(e1 + 1, &e2);
+        if (e2 && e2 != e1 + 1 && *e2 == '/') out->align_temp_c = std::strtod(e2 + 1, &e3);
+        if (e3 && e3 != e2 + 1 && *e3 == '/') {
+            out->align_stale = std::strtol(e3 + 1, nullptr, 10);
+            out->has_align = true;
+        }
+    }
+    out->has_drift = false;
+    const char* pdr = report_field(aend, "DR:");
+    if (pdr) {
+        char* e = nullptr;
+        const char* q = pdr;
+        long v[2];
+        bool ok = true;
+        for (long& x : v) {
+            x = std::strtol(q, &e, 10);
+            if (e == q || *e != '/') { ok = false; break; }
+            q = e + 1;
+        }
+        if (ok) {
+            out->drift_ppm = std::strtod(q, &e);
+            ok = e != q && *e == '/';
+        }
+        if (ok) {
+            q = e + 1;
+            out->jitter_us = std::strtol(q, &e, 10);
+            ok = e != q && *e == '/';
+        }
+        if (ok) {
+            out->drift_n = v[0];
+            out->period_us = v[1];
+            out->drift_outliers = std::strtol(e + 1, nullptr, 10);
+            out->has_drift = true;
+        }
+    }
+    out->has_tc = false;
+    const char* ptc = report_field(aend, "TC:");
+    if (ptc) {
+        char* e = nullptr;
+        out->tc_c = std::strtod(ptc, &e);
+        if (e != ptc && *e == '/') {
+            out->tc_fault = (int)std::strtol(e + 1, nullptr, 10);
+            out->has_tc = true;
+        }
+    }
+    out->has_stats = false;
+    out->adc_stats = WindowStats();
+    out->temp_stats = WindowStats();
+    const char* pas = report_field(aend, "AS:");
+    const char* pts = report_field(aend, "TS:");
+    if (pas && pts) {
+        out->has_stats = parse_window_stats(pas, &out->adc_stats) && parse_window_stats(pts, &out->temp_stats);
+    }
+    return true;
+}
+
+inline bool parse_report_line(const std::string& s, ReportLine* out) {
+    return parse_report_line(s.c_str(), out);
+}
+
+#endif /* REPORT_LINE_HPP */
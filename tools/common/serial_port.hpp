@@ -0,0 +1,65 @@
+/*
+ * serial_port.hpp
+ * 上位机工具共用：串口 / pty 打开与原始模式设置
+ */
+#ifndef SERIAL_PORT_HPP
+#define SERIAL_PORT_HPP
+
+#include <string>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+inline speed_t baud_to_speed(int baud) {
+    switch (baud) {
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        default:      return 0;
+    }
+}
+
+// 原始模式 + 波特率；pty 上设波特率会被忽略，无所谓
+inline void set_raw_mode(int fd, int baud) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) return;
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    speed_t sp = baud_to_speed(baud);
+    if (sp) {
+        cfsetispeed(&tio, sp);
+        cfsetospeed(&tio, sp);
+    }
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+// 失败返回 -1 (errno 有效)
+inline int open_serial(const std::string& dev, int baud, int extra_flags = 0) {
+    int fd = ::open(dev.c_str(), O_RDWR | O_NOCTTY | extra_flags);
+    if (fd < 0) return -1;
+    set_raw_mode(fd, baud);
+    return fd;
+}
+
+// 新建 pty，返回主端 fd，从端路径写入 slave；失败返回 -1
+inline int open_pty_master(std::string* slave) {
+    int m = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m < 0) return -1;
+    if (grantpt(m) != 0 || unlockpt(m) != 0) {
+        ::close(m);
+        return -1;
+    }
+    *slave = ptsname(m);
+    // 主端也设原始模式，避免从端没打开前的回显/换行转换
+    set_raw_mode(m, 0);
+    return m;
+}
+
+#endif /* SERIAL_PORT_HPP */
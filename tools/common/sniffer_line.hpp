@@ -0,0 +1,48 @@
+/*
+ * sniffer_line.hpp
+ * 上位机工具共用：解析串口助手/嗅探器日志行 (见 实际数据.txt)
+ *   [毫秒] Len:11 T:28.5 Raw: FC 0A 00 01 1D 01 1C 01 00 F6 00
+ * 只关心时间戳和 Raw: 后面的原始字节。
+ */
+#ifndef SNIFFER_LINE_HPP
+#define SNIFFER_LINE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct SnifferLine {
+    uint64_t t_ms = 0;
+    std::vector<uint8_t> raw;
+};
+
+inline bool parse_sniffer_line(const char* s, SnifferLine* out) {
+    const char* lb = std::strchr(s, '[');
+    if (!lb) return false;
+    char* end = nullptr;
+    unsigned long long t = std::strtoull(lb + 1, &end, 10);
+    if (end == lb + 1 || *end != ']') return false;
+    const char* p = std::strstr(end, "Raw:");
+    if (!p) return false;
+    p += 4;
+
+    out->t_ms = t;
+    out->raw.clear();
+    for (;;) {
+        while (*p == ' ' || *p == '\t') p++;
+        char* e = nullptr;
+        unsigned long v = std::strtoul(p, &e, 16);
+        if (e == p || v > 0xFF) break;
+        out->raw.push_back((uint8_t)v);
+        p = e;
+    }
+    return !out->raw.empty();
+}
+
+inline bool parse_sniffer_line(const std::string& s, SnifferLine* out) {
+    return parse_sniffer_line(s.c_str(), out);
+}
+
+#endif /* SNIFFER_LINE_HPP */
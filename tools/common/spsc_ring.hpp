@@ -0,0 +1,81 @@
+/*
+ * spsc_ring.hpp
+ * 上位机工具共用：单生产者单消费者无锁环形缓冲
+ * 1. 容量为 2 的幂，head/tail 单调递增，只在取下标时 & mask。
+ * 2. 生产者直接往 write_span() 给出的连续空间里 read()，消费者直接拿 read_span() 去 write()，
+ *    全程不拷贝。
+ * 3. head/tail 各占一条缓存行，避免伪共享。
+ */
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+template <typename T>
+class SpscRing {
+public:
+    // capacity 向上取 2 的幂；align 用于 O_DIRECT (按字节对齐分配)
+    explicit SpscRing(size_t capacity, size_t align = 64) {
+        cap_ = 1;
+        while (cap_ < capacity) cap_ <<= 1;
+        mask_ = cap_ - 1;
+        size_t bytes = cap_ * sizeof(T);
+        bytes = (bytes + align - 1) / align * align;
+        buf_ = (T*)std::aligned_alloc(align, bytes);
+        if (!buf_) throw std::bad_alloc();
+    }
+    ~SpscRing() { std::free(buf_); }
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return cap_; }
+    T* base() { return buf_; }
+
+    // ---- 生产者侧 ----
+    // 从 head 开始、不绕回的可写连续空间
+    T* write_span(size_t* n) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t free = cap_ - (head - tail);
+        size_t to_end = cap_ - (head & mask_);
+        *n = free < to_end ? free : to_end;
+        return buf_ + (head & mask_);
+    }
+    void commit_write(size_t n) { head_.fetch_add(n, std::memory_order_release); }
+
+    bool push(const T& v) {
+        size_t n;
+        T* p = write_span(&n);
+        if (n == 0) return false;
+        *p = v;
+        commit_write(1);
+        return true;
+    }
+
+    // ---- 消费者侧 ----
+    size_t readable() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+    size_t read_pos() const { return tail_.load(std::memory_order_relaxed); }
+    const T* at(size_t pos) const { return buf_ + (pos & mask_); }
+    void commit_read(size_t n) { tail_.fetch_add(n, std::memory_order_release); }
+
+    bool pop(T* v) {
+        if (readable() == 0) return false;
+        *v = *at(read_pos());
+        commit_read(1);
+        return true;
+    }
+
+private:
+    T* buf_ = nullptr;
+    size_t cap_ = 0, mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+#endif /* SPSC_RING_HPP */
@@ -0,0 +1,130 @@
+/*
+ * downsample.cpp
+ * 长时间抓包画图前的降采样 (一周 250ms 报告 = 每通道 240 万点)
+ * 功能：
+ * 1. extract：把报告行抓包 ([t] T:x C, ADC:y) 拆成列文件 前缀.t.f64 / .temp.f64 / .adc.f64
+ *    (小端 double 裸数组)，流式处理，只做一次。
+ * 2. lttb / minmax：mmap 列文件，按屏幕宽度降采样 (LTTB 输出 width 点，min/max 输出
+ *    不超过 2*width 点)，多线程，输出 CSV (t,值)。
+ *
+ * 编译：g++ -O2 -std=c++17 -pthread -Itools/common tools/downsample.cpp -o downsample
+ * 用法：downsample extract 抓包.txt 前缀
+ *       downsample lttb|minmax [--width 1920] [--threads N] [-o 输出.csv] 前缀 temp|adc
+ */
+
+#include "downsample.hpp"
+#include "mapped_file.hpp"
+#include "report_line.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define LINE_MAX_LEN  4096
+#define IO_BUF_BYTES  (1u << 20)
+
+static void Usage(void) {
+    std::fprintf(stderr,
+        "用法: downsample extract 抓包.txt 前缀\n"
+        "      downsample lttb|minmax [--width W] [--threads N] [-o 输出.csv] 前缀 temp|adc\n");
+}
+
+// ================= extract =================
+static int Cmd_Extract(const char* in_path, const std::string& prefix) {
+    FILE* in = std::fopen(in_path, "r");
+    if (!in) {
+        std::perror(in_path);
+        return 1;
+    }
+    const char* names[3] = {".t.f64", ".temp.f64", ".adc.f64"};
+    FILE* out[3];
+    for (int i = 0; i < 3; i++) {
+        out[i] = std::fopen((prefix + names[i]).c_str(), "wb");
+        if (!out[i]) {
+            std::perror((prefix + names[i]).c_str());
+            return 1;
+        }
+        setvbuf(out[i], nullptr, _IOFBF, IO_BUF_BYTES);
+    }
+
+    // 固件按键重启后时间从 0 重新计，这里接成单调时间轴
+    char line[LINE_MAX_LEN];
+    ReportLine r;
+    double base = 0.0, last = 0.0;
+    size_t n = 0;
+    while (std::fgets(line, sizeof(line), in)) {
+        if (!parse_report_line(line, &r)) continue;
+        if (r.t_s + base < last) base = last;
+        double v[3] = {r.t_s + base, r.temp_c, (double)r.adc};
+        last = v[0];
+        for (int i = 0; i < 3; i++) std::fwrite(&v[i], sizeof(double), 1, out[i]);
+        n++;
+    }
+    std::fclose(in);
+    for (int i = 0; i < 3; i++) std::fclose(out[i]);
+    std::fprintf(stderr, "提取 %zu 行 -> %s.{t,temp,adc}.f64\n", n, prefix.c_str());
+    return 0;
+}
+
+// ================= lttb / minmax =================
+static int Cmd_Downsample(bool use_lttb, int argc, char** argv) {
+    size_t width = 1920;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string out_path, prefix, column;
+    for (int i = 0; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--width" && i + 1 < argc) width = (size_t)std::atoll(argv[++i]);
+        else if (a == "--threads" && i + 1 < argc) threads = (unsigned)std::atoi(argv[++i]);
+        else if (a == "-o" && i + 1 < argc) out_path = argv[++i];
+        else if (prefix.empty()) prefix = a;
+        else column = a;
+    }
+    if (prefix.empty() || (column != "temp" && column != "adc") || width < 3) {
+        Usage();
+        return 2;
+    }
+    if (threads == 0) threads = 1;
+
+    MappedFile xs, ys;
+    if (!xs.open(prefix + ".t.f64") || !ys.open(prefix + "." + column + ".f64")) {
+        std::fprintf(stderr, "打不开列文件 %s.{t,%s}.f64 (先跑 extract)\n", prefix.c_str(), column.c_str());
+        return 1;
+    }
+    size_t n = xs.size() / sizeof(double);
+    if (ys.size() / sizeof(double) != n) {
+        std::fprintf(stderr, "列长度不一致\n");
+        return 1;
+    }
+    const double* x = (const double*)xs.data();
+    const double* y = (const double*)ys.data();
+
+    std::vector<ds::Point> pts = use_lttb ? ds::lttb(x, y, n, width, threads)
+                                          : ds::minmax(x, y, n, width, threads);
+
+    FILE* out = out_path.empty() ? stdout : std::fopen(out_path.c_str(), "w");
+    if (!out) {
+        std::perror(out_path.c_str());
+        return 1;
+    }
+    std::fprintf(out, "t,%s\n", column.c_str());
+    for (const ds::Point& p : pts) std::fprintf(out, "%.3f,%.6g\n", p.x, p.y);
+    if (out != stdout) std::fclose(out);
+    std::fprintf(stderr, "%zu 点 -> %zu 点 (%s, %u 线程)\n", n, pts.size(), use_lttb ? "lttb" : "minmax", threads);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        Usage();
+        return 2;
+    }
+    std::string cmd = argv[1];
+    if (cmd == "extract" && argc == 4) return Cmd_Extract(argv[2], argv[3]);
+    if (cmd == "lttb") return Cmd_Downsample(true, argc - 2, argv + 2);
+    if (cmd == "minmax") return Cmd_Downsample(false, argc - 2, argv + 2);
+    Usage();
+    return 2;
+}
@@ -0,0 +1,11 @@
+/*
+ * adc.h (上位机替身)
+ */
+#ifndef __ADC_H__
+#define __ADC_H__
+
+#include "main.h"
+
+extern ADC_HandleTypeDef hadc1;
+
+#endif /* __ADC_H__ */
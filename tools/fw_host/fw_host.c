@@ -0,0 +1,94 @@
+/*
+ * fw_host.c
+ * 上位机替身的实现：外设寄存器是普通全局变量，HAL 函数不碰硬件。
+ * 1. 时基 host_tick 由测试程序自己推进，HAL_GetTick 只读它。
+ * 2. 串口发送寄存器 SR 一直是 TXE|TC，固件的阻塞发送不会卡住；发出的字节丢掉。
+ * 3. 栈高水位在 PC 上没有意义，Stack_Watch_* 返回 0。
+ */
+
+#include "main.h"
+#include "usart.h"
+#include "adc.h"
+#include "stack_watch.h"
+
+// ================= 寄存器 =================
+DWT_Type host_dwt;
+CoreDebug_Type host_coredebug;
+GPIO_TypeDef host_gpioa, host_gpiob, host_gpioc;
+USART_TypeDef host_usart1 = { .SR = USART_SR_TXE | USART_SR_TC };
+USART_TypeDef host_usart2 = { .SR = USART_SR_TXE | USART_SR_TC };
+USART_TypeDef host_usart3 = { .SR = USART_SR_TXE | USART_SR_TC };
+ADC_TypeDef host_adc1 = { .SR = ADC_SR_EOC };
+
+uint32_t SystemCoreClock = 72000000;
+
+// ================= 句柄 =================
+UART_HandleTypeDef huart1 = { .Instance = USART1 };
+UART_HandleTypeDef huart2 = { .Instance = USART2 };
+UART_HandleTypeDef huart3 = { .Instance = USART3 };
+ADC_HandleTypeDef hadc1 = { .Instance = ADC1 };
+
+uint32_t host_tick = 0;
+
+// ================= HAL =================
+uint32_t HAL_GetTick(void) {
+    return host_tick;
+}
+
+void HAL_Delay(uint32_t ms) {
+    host_tick += ms;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init) {
+    (void)port;
+    (void)init;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *h, uint8_t *p, uint16_t n, uint32_t timeout) {
+    (void)h;
+    (void)p;
+    (void)n;
+    (void)timeout;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *h, uint8_t *p, uint16_t n) {
+    (void)h;
+    (void)p;
+    (void)n;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *h, ADC_ChannelConfTypeDef *c) {
+    (void)h;
+    (void)c;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *h) {
+    (void)h;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef *h) {
+    (void)h;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *h, uint32_t timeout) {
+    (void)h;
+    (void)timeout;
+    return HAL_OK;
+}
+
+// ================= 栈高水位 =================
+void Stack_Watch_Scan(void) {
+}
+
+uint16_t Stack_Watch_Size(void) {
+    return 0;
+}
+
+uint16_t Stack_Watch_Peak(void) {
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * main.h (上位机替身)
+ * 在 PC 上编译固件源文件用：只给出固件实际用到的 HAL/CMSIS 类型、寄存器和函数声明，
+ * 外设寄存器是普通内存，HAL 函数由 fw_host.c 实现 (不碰硬件，直接返回 HAL_OK)。
+ * 编译时把 tools/fw_host 放在 miku666/H 前面，Core/Inc 不加。
+ */
+#ifndef MAIN_H
+#define MAIN_H
+
+#include <stdint.h>
+
+// ================= CMSIS =================
+#define __disable_irq()     ((void)0)
+#define __enable_irq()      ((void)0)
+#define __get_PRIMASK()     0u
+#define __set_PRIMASK(x)    ((void)(x))
+
+extern uint32_t SystemCoreClock;
+
+typedef struct { volatile uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_coredebug;
+#define DWT                         (&host_dwt)
+#define CoreDebug                   (&host_coredebug)
+#define DWT_CTRL_CYCCNTENA_Msk      1u
+#define CoreDebug_DEMCR_TRCENA_Msk  (1u << 24)
+
+// ================= 外设寄存器 =================
+typedef struct { volatile uint32_t CRL, CRH, IDR, ODR, BSRR, BRR, LCKR; } GPIO_TypeDef;
+typedef struct { volatile uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR; } USART_TypeDef;
+typedef struct { volatile uint32_t SR, CR1, CR2, DR; } ADC_TypeDef;
+
+extern GPIO_TypeDef host_gpioa, host_gpiob, host_gpioc;
+extern USART_TypeDef host_usart1, host_usart2, host_usart3;
+extern ADC_TypeDef host_adc1;
+#define GPIOA   (&host_gpioa)
+#define GPIOB   (&host_gpiob)
+#define GPIOC   (&host_gpioc)
+#define USART1  (&host_usart1)
+#define USART2  (&host_usart2)
+#define USART3  (&host_usart3)
+#define ADC1    (&host_adc1)
+
+#define USART_SR_TXE    (1u << 7)
+#define USART_SR_TC     (1u << 6)
+#define USART_SR_RXNE   (1u << 5)
+#define ADC_SR_EOC      (1u << 1)
+
+// ================= 引脚 (与 Core/Inc/main.h 一致) =================
+#define GPIO_PIN_1      0x0002u
+#define GPIO_PIN_2      0x0004u
+#define GPIO_PIN_3      0x0008u
+#define GPIO_PIN_4      0x0010u
+#define GPIO_PIN_5      0x0020u
+#define GPIO_PIN_6      0x0040u
+#define GPIO_PIN_7      0x0080u
+#define GPIO_PIN_13     0x2000u
+
+#define LED0_Pin                GPIO_PIN_13
+#define LED0_GPIO_Port          GPIOC
+#define LED1_Pin                GPIO_PIN_1
+#define LED1_GPIO_Port          GPIOA
+#define LED2_Pin                GPIO_PIN_2
+#define LED2_GPIO_Port          GPIOA
+#define BOTTON1_Pin             GPIO_PIN_3
+#define BOTTON1_GPIO_Port       GPIOA
+#define BOTTON2_Pin             GPIO_PIN_4
+#define BOTTON2_GPIO_Port       GPIOA
+#define Monitor_CS_Pin          GPIO_PIN_5
+#define Monitor_CS_GPIO_Port    GPIOB
+#define Monitor_SCK_Pin         GPIO_PIN_6
+#define Monitor_SCK_GPIO_Port   GPIOB
+#define Monitor_SO_Pin          GPIO_PIN_7
+#define Monitor_SO_GPIO_Port    GPIOB
+
+// ================= HAL =================
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+typedef struct { USART_TypeDef *Instance; volatile uint32_t ErrorCode; } UART_HandleTypeDef;
+typedef struct { ADC_TypeDef *Instance; } ADC_HandleTypeDef;
+typedef struct { uint32_t Channel, Rank, SamplingTime; } ADC_ChannelConfTypeDef;
+typedef struct { uint32_t Pin, Mode, Pull, Speed; } GPIO_InitTypeDef;
+
+#define ADC_CHANNEL_0               0u
+#define ADC_CHANNEL_8               8u
+#define ADC_CHANNEL_9               9u
+#define ADC_REGULAR_RANK_1          1u
+#define ADC_SAMPLETIME_28CYCLES_5   3u
+#define GPIO_MODE_OUTPUT_PP         1u
+#define GPIO_NOPULL                 0u
+#define GPIO_SPEED_FREQ_LOW         2u
+
+#define __HAL_UART_CLEAR_OREFLAG(h) ((void)(h))
+#define __HAL_UART_CLEAR_NEFLAG(h)  ((void)(h))
+#define __HAL_UART_CLEAR_FEFLAG(h)  ((void)(h))
+
+extern uint32_t host_tick;   // HAL_GetTick 的值，由测试程序推进
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *h, uint8_t *p, uint16_t n, uint32_t timeout);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *h, uint8_t *p, uint16_t n);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *h, ADC_ChannelConfTypeDef *c);
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *h);
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef *h);
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *h, uint32_t timeout);
+
+#endif /* MAIN_H */
@@ -0,0 +1,11 @@
+/*
+ * usart.h (上位机替身)
+ */
+#ifndef __USART_H__
+#define __USART_H__
+
+#include "main.h"
+
+extern UART_HandleTypeDef huart1;
+
+#endif /* __USART_H__ */
@@ -0,0 +1,207 @@
+/*
+ * jrzx_scan.cpp
+ * 原始二进制串口抓包的帧扫描工具
+ * 功能：
+ * 1. 在字节流中找 0xFC 候选帧头 (AVX2 32字节/SSE2 16字节/标量回退)，再校验长度和 XOR。
+ * 2. 默认输出统计：各 CMD 帧数、温度帧数、帧外垃圾字节数。
+ * 3. --dump 逐帧输出；--bench 与固件同款逐字节状态机对比吞吐。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/jrzx_scan.cpp -o jrzx_scan
+ * 用法：jrzx_scan [--impl auto|scalar|sse2|avx2] [--dump] [--bench N] [--synth MB] 文件...
+ */
+
+#include "jrzx.hpp"
+#include "mapped_file.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ================= 参数 =================
+struct Options {
+    jrzx::Impl impl = jrzx::Impl::Auto;
+    bool dump = false;
+    int bench_rounds = 0;       // 0: 不跑基准
+    size_t synth_mb = 0;        // 0: 不生成合成数据
+    std::vector<std::string> files;
+};
+
+static void Usage(void) {
+    std::fprintf(stderr,
+        "用法: jrzx_scan [--impl auto|scalar|sse2|avx2] [--dump] [--bench N] [--synth MB] 文件...\n"
+        "  --dump      逐帧输出: 偏移 长度 CMD [温度] 原始字节\n"
+        "  --bench N   每种实现跑 N 轮，输出 MB/s (含逐字节状态机对照)\n"
+        "  --synth MB  生成 MB 兆字节的合成抓包 (真实帧 + 随机噪声) 代替文件\n");
+}
+
+static bool Parse_Args(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--impl" && i + 1 < argc) {
+            std::string v = argv[++i];
+            if (v == "auto") opt->impl = jrzx::Impl::Auto;
+            else if (v == "scalar") opt->impl = jrzx::Impl::Scalar;
+            else if (v == "sse2") opt->impl = jrzx::Impl::SSE2;
+            else if (v == "avx2") opt->impl = jrzx::Impl::AVX2;
+            else return false;
+        } else if (a == "--dump") {
+            opt->dump = true;
+        } else if (a == "--bench" && i + 1 < argc) {
+            opt->bench_rounds = std::atoi(argv[++i]);
+        } else if (a == "--synth" && i + 1 < argc) {
+            opt->synth_mb = (size_t)std::atoll(argv[++i]);
+        } else if (a.size() > 1 && a[0] == '-') {
+            return false;
+        } else {
+            opt->files.push_back(a);
+        }
+    }
+    return !opt->files.empty() || opt->synth_mb > 0;
+}
+
+// ================= 合成数据 =================
+// 模仿 实际数据.txt 的节奏：一个 FC 0A 应答 + 一个 FC 05 请求，帧后跟一个 00，
+// 偶尔插入随机噪声字节 (含 0xFC) 和截断帧。
+static std::vector<uint8_t> Make_Synthetic(size_t bytes) {
+    std::vector<uint8_t> out;
+    out.reserve(bytes + 64);
+    std::mt19937 rng(12345);
+    uint8_t frame[32];
+    while (out.size() < bytes) {
+        uint16_t t = (uint16_t)(250 + rng() % 100);
+        uint8_t payload[5] = {(uint8_t)t, (uint8_t)(t >> 8), 0x1C, 0x01, 0x00};
+        size_t n = jrzx::build_frame(frame, jrzx::CMD_TEMP, payload, sizeof(payload));
+        out.insert(out.end(), frame, frame + n);
+        out.push_back(0x00);
+
+        n = jrzx::build_frame(frame, jrzx::CMD_TEMP, nullptr, 0);
+        if (rng() % 16 == 0) n--;   // 截断 (Len:5 T:Err 那种)
+        out.insert(out.end(), frame, frame + n);
+        out.push_back(0x00);
+
+        int noise = (int)(rng() % 8);
+        for (int i = 0; i < noise; i++) out.push_back((uint8_t)(rng() % 4 == 0 ? 0xFC : rng()));
+    }
+    return out;
+}
+
+// ================= 统计与输出 =================
+struct ScanStats {
+    size_t frames = 0;
+    size_t frame_bytes = 0;
+    size_t temp_frames = 0;
+    size_t by_cmd[256] = {0};
+};
+
+static void Dump_Frame(const jrzx::Frame& f) {
+    std::printf("%zu %zu %02X", f.offset, f.len, f.cmd);
+    int deci;
+    if (jrzx::frame_temp_deci(f, &deci)) std::printf(" T:%d.%d", deci / 10, deci % 10);
+    std::printf(" Raw:");
+    for (size_t i = 0; i < f.len; i++) std::printf(" %02X", f.data[i]);
+    std::printf("\n");
+}
+
+static void Scan_Buffer(const uint8_t* p, size_t n, const Options& opt, ScanStats* st) {
+    jrzx::scan_frames(p, n, opt.impl, [&](const jrzx::Frame& f) {
+        st->frames++;
+        st->frame_bytes += f.len;
+        st->by_cmd[f.cmd]++;
+        int deci;
+        if (jrzx::frame_temp_deci(f, &deci)) st->temp_frames++;
+        if (opt.dump) Dump_Frame(f);
+    });
+}
+
+static void Print_Stats(const char* name, size_t bytes, const ScanStats& st) {
+    std::printf("%s: %zu 字节, %zu 帧 (温度帧 %zu), 帧外字节 %zu\n",
+                name, bytes, st.frames, st.temp_frames, bytes - st.frame_bytes);
+    for (int c = 0; c < 256; c++) {
+        if (st.by_cmd[c]) std::printf("  CMD %02X: %zu\n", c, st.by_cmd[c]);
+    }
+}
+
+// ================= 基准 =================
+template <typename Fn>
+static double Time_MBps(const uint8_t* p, size_t n, int rounds, Fn&& fn, size_t* result) {
+    double best = 0.0;
+    for (int r = 0; r < rounds; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        *result = fn(p, n);
+        auto t1 = std::chrono::steady_clock::now();
+        double sec = std::chrono::duration<double>(t1 - t0).count();
+        double mbps = (double)n / (1024.0 * 1024.0) / (sec > 0 ? sec : 1e-9);
+        if (mbps > best) best = mbps;
+    }
+    return best;
+}
+
+static void Run_Bench(const uint8_t* p, size_t n, int rounds) {
+    size_t res = 0;
+    double v = Time_MBps(p, n, rounds, [](const uint8_t* d, size_t len) {
+        jrzx::ByteStateMachine sm;
+        size_t temps = 0;
+        for (size_t i = 0; i < len; i++) sm.feed(d[i], [&](int) { temps++; });
+        return temps;
+    }, &res);
+    std::printf("bytewise-sm  %9.1f MB/s  温度帧 %zu\n", v, res);
+
+    const jrzx::Impl impls[] = {jrzx::Impl::Scalar, jrzx::Impl::SSE2, jrzx::Impl::AVX2};
+    size_t ref = (size_t)-1;
+    for (jrzx::Impl impl : impls) {
+        jrzx::Impl real = jrzx::resolve_impl(impl);
+        if (real != impl) {
+            std::printf("%-12s (本机不支持，跳过)\n", jrzx::impl_name(impl));
+            continue;
+        }
+        v = Time_MBps(p, n, rounds, [impl](const uint8_t* d, size_t len) {
+            return jrzx::scan_frames(d, len, impl, [](const jrzx::Frame&) {});
+        }, &res);
+        std::printf("%-12s %9.1f MB/s  有效帧 %zu%s\n", jrzx::impl_name(impl), v, res,
+                    (ref != (size_t)-1 && res != ref) ? "  !! 与标量结果不一致" : "");
+        if (ref == (size_t)-1) ref = res;
+    }
+}
+
+// ================= 主函数 =================
+int main(int argc, char** argv) {
+    Options opt;
+    if (!Parse_Args(argc, argv, &opt)) {
+        Usage();
+        return 2;
+    }
+
+    if (opt.synth_mb > 0) {
+        std::vector<uint8_t> buf = Make_Synthetic(opt.synth_mb * 1024 * 1024);
+        if (opt.bench_rounds > 0) {
+            Run_Bench(buf.data(), buf.size(), opt.bench_rounds);
+        } else {
+            ScanStats st;
+            Scan_Buffer(buf.data(), buf.size(), opt, &st);
+            Print_Stats("synth", buf.size(), st);
+        }
+    }
+
+    int rc = 0;
+    for (const std::string& path : opt.files) {
+        MappedFile mf;
+        if (!mf.open(path)) {
+            std::fprintf(stderr, "打不开 %s: %s\n", path.c_str(), std::strerror(errno));
+            rc = 1;
+            continue;
+        }
+        if (opt.bench_rounds > 0) {
+            std::printf("== %s (%zu 字节)\n", path.c_str(), mf.size());
+            Run_Bench(mf.data(), mf.size(), opt.bench_rounds);
+        } else {
+            ScanStats st;
+            Scan_Buffer(mf.data(), mf.size(), opt, &st);
+            Print_Stats(path.c_str(), mf.size(), st);
+        }
+    }
+    return rc;
+}
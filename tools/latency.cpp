@@ -0,0 +1,141 @@
+/*
+ * latency.cpp
+ * 端到端延迟：传感器帧发出 -> 上位机收到对应报告行
+ * 流程：
+ * 1. traffic_gen --mark --interval 270 --port 传感器口 --manifest m.csv
+ *    (温度帧第二个温度字 = 帧序号，清单里记发出时刻)
+ * 2. 固件用 MONITOR_LATENCY_MARK=1 编译，报告行带 ", M:序号"
+ * 3. capture_d 抓设备输出口，得到 out.bin + out.idx (每批字节的到达时刻)
+ * 4. latency --manifest m.csv --label 配置名 out.bin
+ * 报告行到达时刻取其换行符所在那批字节的时刻；序号只有 16 位，按 "到达前最近一次发出" 展开。
+ * 两边时刻都是同一台主机的 CLOCK_REALTIME。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/latency.cpp -o latency
+ * 用法：latency --manifest m.csv [--label 名字] [--append 汇总.csv] 设备输出.bin
+ */
+
+#include "capture_file.hpp"
+#include "report_line.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define MARK_SPACE  65536
+
+static void Usage(void) {
+    std::fprintf(stderr, "用法: latency --manifest m.csv [--label 名字] [--append 汇总.csv] 设备输出.bin\n");
+}
+
+// 清单里带序号的温度帧：sends[mark] = 该序号每次发出的时刻 (递增)
+static bool Load_Manifest(const std::string& path, std::vector<std::vector<uint64_t>>* sends) {
+    FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return false;
+    sends->assign(MARK_SPACE, {});
+    char line[512];
+    std::fgets(line, sizeof(line), f);   // 表头
+    while (std::fgets(line, sizeof(line), f)) {
+        // seq,offset,len,type,cmd,temp_deci,faults,valid,t_ns,mark
+        unsigned long long t_ns = 0;
+        int valid = 0, mark = -1;
+        const char* p = line;
+        int col = 0;
+        while (p && *p) {
+            if (col == 7) valid = std::atoi(p);
+            else if (col == 8) t_ns = std::strtoull(p, nullptr, 10);
+            else if (col == 9) mark = std::atoi(p);
+            p = std::strchr(p, ',');
+            if (p) p++;
+            col++;
+        }
+        if (valid && mark >= 0 && mark < MARK_SPACE) (*sends)[mark].push_back(t_ns);
+    }
+    std::fclose(f);
+    return true;
+}
+
+static double Pct(const std::vector<double>& v, double q) {
+    if (v.empty()) return 0.0;
+    size_t i = (size_t)(q * (double)(v.size() - 1) + 0.5);
+    return v[std::min(i, v.size() - 1)];
+}
+
+int main(int argc, char** argv) {
+    std::string manifest, label = "default", append, capture;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--manifest" && i + 1 < argc) manifest = argv[++i];
+        else if (a == "--label" && i + 1 < argc) label = argv[++i];
+        else if (a == "--append" && i + 1 < argc) append = argv[++i];
+        else if (a.size() > 1 && a[0] == '-') { Usage(); return 2; }
+        else capture = a;
+    }
+    if (manifest.empty() || capture.empty()) {
+        Usage();
+        return 2;
+    }
+
+    std::vector<std::vector<uint64_t>> sends;
+    if (!Load_Manifest(manifest, &sends)) {
+        std::perror(manifest.c_str());
+        return 1;
+    }
+    CaptureReader rd;
+    if (!rd.open(capture)) {
+        std::fprintf(stderr, "打不开 %s (需要同名 .idx)\n", capture.c_str());
+        return 1;
+    }
+
+    std::vector<double> lat_ms;
+    size_t reports = 0, unmatched = 0;
+    std::string line;
+    uint64_t t;
+    const uint8_t* data;
+    size_t len;
+    ReportLine r;
+    while (rd.next(&t, &data, &len)) {
+        for (size_t i = 0; i < len; i++) {
+            char c = (char)data[i];
+            if (c != '\n') {
+                if (line.size() < 512) line.push_back(c);
+                continue;
+            }
+            if (parse_report_line(line, &r) && r.mark >= 0) {
+                reports++;
+                const std::vector<uint64_t>& v = sends[r.mark & (MARK_SPACE - 1)];
+                // 到达前最近一次发出
+                auto it = std::upper_bound(v.begin(), v.end(), t);
+                if (it == v.begin()) unmatched++;
+                else lat_ms.push_back((double)(t - *(it - 1)) / 1e6);
+            }
+            line.clear();
+        }
+    }
+    if (lat_ms.empty()) {
+        std::fprintf(stderr, "没有可匹配的报告行 (固件是否开了 MONITOR_LATENCY_MARK？)\n");
+        return 1;
+    }
+    std::sort(lat_ms.begin(), lat_ms.end());
+    double sum = 0.0;
+    for (double v : lat_ms) sum += v;
+    double p50 = Pct(lat_ms, 0.50), p99 = Pct(lat_ms, 0.99), mx = lat_ms.back();
+    std::printf("%s: 报告 %zu 行, 匹配 %zu, 未匹配 %zu, 延迟 mean %.1fms p50 %.1fms p99 %.1fms max %.1fms\n",
+                label.c_str(), reports, lat_ms.size(), unmatched, sum / (double)lat_ms.size(), p50, p99, mx);
+
+    if (!append.empty()) {
+        FILE* f = std::fopen(append.c_str(), "a+");
+        if (!f) {
+            std::perror(append.c_str());
+            return 1;
+        }
+        std::fseek(f, 0, SEEK_END);
+        if (std::ftell(f) == 0) std::fprintf(f, "label,n,mean_ms,p50_ms,p99_ms,max_ms\n");
+        std::fprintf(f, "%s,%zu,%.2f,%.2f,%.2f,%.2f\n", label.c_str(), lat_ms.size(),
+                     sum / (double)lat_ms.size(), p50, p99, mx);
+        std::fclose(f);
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * merge.cpp
+ * 多台设备抓包按时间 k 路归并成一条带设备标签的流
+ * 功能：
+ * 1. 输入可以混用：固件报告行 ([12.25s] T:..)、嗅探日志 ([1744] Len:.. Raw:..)、
+ *    capture_d 的 .bin + .idx (自带绝对时刻)。
+ * 2. 对齐：.bin 用绝对时刻；文本默认按 "文件修改时间 = 最后一行时刻" 估计偏移，
+ *    也可以写 路径@偏移ms 指定绝对偏移 (毫秒，Unix 纪元)；--align start 不做绝对对齐，
+ *    文本流直接用各自的相对时间，.bin 从第一批字节算 0 (多块板同时上电时用)。
+ * 3. 每路只缓存一条待输出记录，小根堆按时刻取最小，内存与文件长度无关；
+ *    大块 stdio 缓冲，跑满磁盘带宽。
+ * 输出每行：绝对毫秒 设备标签 原始行 (二进制流输出成嗅探日志格式 [相对ms] Len:N Raw: ..)，
+ * 原始行保持不变，所以 report_line / sniffer_line 解析器都能直接吃合并结果。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/merge.cpp -o merge
+ * 用法：merge [--align mtime|start] [--tag 名字,...] [-o 输出] 流1 [流2@偏移ms ...]
+ */
+
+#include "capture_file.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+// ================= 参数 =================
+#define LINE_MAX_LEN   4096
+#define IO_BUF_BYTES   (1u << 20)
+#define TAIL_BYTES     8192       // 估计偏移时只读文件尾部找最后一个时间戳
+
+struct Options {
+    bool align_start = false;
+    std::vector<std::string> tags;
+    std::string out;
+    std::vector<std::string> inputs;
+};
+
+// 文本行的相对时间 (毫秒)：[12.25s] 按秒，[1744] 按毫秒；没有时间戳返回 false
+static bool Line_Time_Ms(const char* s, double* ms) {
+    const char* lb = std::strchr(s, '[');
+    if (!lb) return false;
+    char* end = nullptr;
+    double v = std::strtod(lb + 1, &end);
+    if (end == lb + 1) return false;
+    if (*end == 's') { *ms = v * 1000.0; return true; }
+    if (*end == ']') { *ms = v; return true; }
+    return false;
+}
+
+// ================= 输入流 =================
+class Stream {
+public:
+    virtual ~Stream() = default;
+    // 取下一条：绝对毫秒 + 输出正文 (不含换行)
+    virtual bool next(double* abs_ms, std::string* body) = 0;
+    std::string tag;
+};
+
+// 文本流：相对时间 + 偏移。固件按键重启后时间从 0 重新计，
+// 检测到时间倒退就把之前的最大时刻累加成新段的基准，保持单调。
+class TextStream : public Stream {
+public:
+    bool open(const std::string& path, bool has_offset, double offset_ms, bool align_start) {
+        f_ = std::fopen(path.c_str(), "r");
+        if (!f_) return false;
+        buf_.resize(IO_BUF_BYTES);
+        setvbuf(f_, buf_.data(), _IOFBF, buf_.size());
+        if (has_offset) offset_ms_ = offset_ms;
+        else if (!align_start) offset_ms_ = Estimate_Offset(path);
+        return true;
+    }
+    ~TextStream() override { if (f_) std::fclose(f_); }
+
+    bool next(double* abs_ms, std::string* body) override {
+        char line[LINE_MAX_LEN];
+        while (std::fgets(line, sizeof(line), f_)) {
+            size_t n = std::strlen(line);
+            while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r')) line[--n] = '\0';
+            if (n == 0) continue;
+            double t;
+            if (Line_Time_Ms(line, &t)) {
+                if (t + seg_base_ < last_) seg_base_ = last_;
+                last_ = t + seg_base_;
+            }
+            *abs_ms = offset_ms_ + last_;
+            body->assign(line, n);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // 文件修改时间 ≈ 最后一行写入时刻
+    double Estimate_Offset(const std::string& path) {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return 0.0;
+        double mtime_ms = (double)st.st_mtim.tv_sec * 1000.0 + (double)st.st_mtim.tv_nsec / 1e6;
+        long size = (long)st.st_size;
+        std::fseek(f_, size > TAIL_BYTES ? size - TAIL_BYTES : 0, SEEK_SET);
+        char line[LINE_MAX_LEN];
+        double last = 0.0, t;
+        while (std::fgets(line, sizeof(line), f_)) {
+            if (Line_Time_Ms(line, &t)) last = t;
+        }
+        std::fseek(f_, 0, SEEK_SET);
+        return mtime_ms - last;
+    }
+
+    FILE* f_ = nullptr;
+    std::vector<char> buf_;
+    double offset_ms_ = 0.0;
+    double seg_base_ = 0.0;
+    double last_ = 0.0;
+};
+
+// 二进制流：每条索引一批字节
+class BinStream : public Stream {
+public:
+    bool open(const std::string& path, bool align_start) {
+        align_start_ = align_start;
+        return reader_.open(path);
+    }
+    bool next(double* abs_ms, std::string* body) override {
+        uint64_t t;
+        const uint8_t* data;
+        size_t len;
+        if (!reader_.next(&t, &data, &len)) return false;
+        if (first_) { t0_ = t; first_ = false; }
+        double rel_ms = (double)(t - t0_) / 1e6;
+        *abs_ms = align_start_ ? rel_ms : (double)t / 1e6;
+
+        char head[64];
+        int n = std::snprintf(head, sizeof(head), "[%.0f] Len:%zu Raw:", rel_ms, len);
+        body->assign(head, (size_t)n);
+        static const char hex[] = "0123456789ABCDEF";
+        for (size_t i = 0; i < len; i++) {
+            char b[3] = {' ', hex[data[i] >> 4], hex[data[i] & 0xF]};
+            body->append(b, 3);
+        }
+        return true;
+    }
+
+private:
+    CaptureReader reader_;
+    bool align_start_ = false;
+    bool first_ = true;
+    uint64_t t0_ = 0;
+};
+
+// ================= 归并 =================
+struct HeapItem {
+    double t;
+    size_t stream;
+    uint64_t seq;     // 同时刻按到达先后，保证稳定
+    bool operator>(const HeapItem& o) const {
+        if (t != o.t) return t > o.t;
+        if (stream != o.stream) return stream > o.stream;
+        return seq > o.seq;
+    }
+};
+
+static void Usage(void) {
+    std::fprintf(stderr,
+        "用法: merge [--align mtime|start] [--tag 名字,...] [-o 输出] 流1 [流2@偏移ms ...]\n"
+        "  流: 报告行/嗅探日志文本，或 capture_d 的 .bin (需同名 .idx)\n"
+        "  @偏移ms: 文本流第 0 ms 对应的 Unix 毫秒；不写则按文件修改时间估计\n");
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--align" && i + 1 < argc) opt.align_start = std::string(argv[++i]) == "start";
+        else if (a == "--tag" && i + 1 < argc) {
+            std::string s = argv[++i];
+            size_t p = 0, q;
+            while ((q = s.find(',', p)) != std::string::npos) { opt.tags.push_back(s.substr(p, q - p)); p = q + 1; }
+            opt.tags.push_back(s.substr(p));
+        }
+        else if (a == "-o" && i + 1 < argc) opt.out = argv[++i];
+        else if (a.size() > 1 && a[0] == '-') { Usage(); return 2; }
+        else opt.inputs.push_back(a);
+    }
+    if (opt.inputs.empty()) {
+        Usage();
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (size_t i = 0; i < opt.inputs.size(); i++) {
+        std::string path = opt.inputs[i];
+        bool has_off = false;
+        double off = 0.0;
+        size_t at = path.rfind('@');
+        if (at != std::string::npos) {
+            off = std::atof(path.c_str() + at + 1);
+            has_off = true;
+            path.resize(at);
+        }
+        std::unique_ptr<Stream> s;
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".bin") == 0) {
+            auto b = std::make_unique<BinStream>();
+            if (b->open(path, opt.align_start)) s = std::move(b);
+        } else {
+            auto t = std::make_unique<TextStream>();
+            if (t->open(path, has_off, off, opt.align_start)) s = std::move(t);
+        }
+        if (!s) {
+            std::fprintf(stderr, "打不开 %s: %s\n", path.c_str(), std::strerror(errno));
+            return 1;
+        }
+        s->tag = i < opt.tags.size() ? opt.tags[i] : "dev" + std::to_string(i);
+        streams.push_back(std::move(s));
+    }
+
+    FILE* out = opt.out.empty() ? stdout : std::fopen(opt.out.c_str(), "w");
+    if (!out) {
+        std::perror(opt.out.c_str());
+        return 1;
+    }
+    std::vector<char> obuf(IO_BUF_BYTES);
+    setvbuf(out, obuf.data(), _IOFBF, obuf.size());
+
+    // 每路一条待输出
+    std::vector<std::string> pending(streams.size());
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+    uint64_t seq = 0;
+    for (size_t i = 0; i < streams.size(); i++) {
+        double t;
+        if (streams[i]->next(&t, &pending[i])) heap.push({t, i, seq++});
+    }
+
+    uint64_t lines = 0;
+    while (!heap.empty()) {
+        HeapItem top = heap.top();
+        heap.pop();
+        std::fprintf(out, "%.3f %s %s\n", top.t, streams[top.stream]->tag.c_str(), pending[top.stream].c_str());
+        lines++;
+        double t;
+        if (streams[top.stream]->next(&t, &pending[top.stream])) heap.push({t, top.stream, seq++});
+    }
+    if (out != stdout) std::fclose(out);
+    else std::fflush(out);
+    std::fprintf(stderr, "合并 %zu 路，输出 %llu 行\n", streams.size(), (unsigned long long)lines);
+    return 0;
+}
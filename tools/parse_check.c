@@ -0,0 +1,75 @@
+/*
+ * parse_check.c
+ * 在 PC 上跑固件的 JRZX 解析器 (Monitor_Feed_Byte)，核对坏帧不会改掉温度
+ * 1. 直接包含 Monitor_usart.c，能看到 Monitor_t 内部的计数和最新温度；
+ *    HAL 和寄存器由 tools/fw_host 的替身提供，固件源码不改。
+ * 2. 用例：好帧更新温度；XOR 错的帧 (内容换了温度) 被丢弃、记 rx_bad_xor、温度保持上一帧；
+ *    之后的好帧照常解析 (解析器已回到找帧头)。
+ *
+ * 编译 (仓库根目录)：
+ *   gcc -std=gnu99 -Wall -Itools/fw_host -Imiku666/H -Imiku666/C tools/parse_check.c \
+ *       tools/fw_host/fw_host.c miku666/C/trace.c miku666/C/profile.c miku666/C/histogram.c -o parse_check
+ * 用法：parse_check    全部通过返回 0，否则打印失败项并返回 1
+ */
+
+#include "Monitor_usart.c"
+
+// 传感器一帧：FC | 0A 00 | 01 | 温度 LSB MSB | 第二温度字 | XOR，后跟一个 00
+static void Build_Temp_Frame(uint8_t *f, int16_t deci) {
+    uint8_t x = 0;
+    f[0] = MONITOR_FRAME_HEAD;
+    f[1] = 0x0A;
+    f[2] = 0x00;
+    f[3] = MONITOR_CMD_TEMP;
+    f[4] = (uint8_t)deci;
+    f[5] = (uint8_t)((uint16_t)deci >> 8);
+    f[6] = 0x1C;
+    f[7] = 0x01;
+    f[8] = 0x00;
+    for (uint8_t i = 0; i < 9; i++) x ^= f[i];
+    f[9] = x;
+    f[10] = 0x00;
+}
+
+static void Feed(Monitor_t *m, const uint8_t *f, uint8_t n) {
+    for (uint8_t i = 0; i < n; i++) {
+        Monitor_Feed_Byte(m, f[i]);
+        host_tick++;
+    }
+}
+
+static int failed = 0;
+
+static void Check(int cond, const char *what) {
+    printf("%s: %s\n", cond ? "OK  " : "FAIL", what);
+    if (!cond) failed = 1;
+}
+
+int main(void) {
+    static const uint8_t bench_frame[] = {0xFC,0x0A,0x00,0x01,0x1D,0x01,0x1C,0x01,0x00,0xF6,0x00};   // bench.c 里的实测帧，28.5 度
+    uint8_t f[11];
+    Monitor_t *m;
+
+    Monitor_Init();
+    m = Monitor_Get(0);
+
+    Feed(m, bench_frame, sizeof(bench_frame));
+    Check(m->rx_frames == 1 && m->latest_temp_deci == 285 && m->has_valid_data, "好帧更新温度 (28.5 度)");
+
+    Build_Temp_Frame(f, 300);
+    f[9] ^= 0x01;
+    Feed(m, f, sizeof(f));
+    Check(m->rx_bad_xor == 1, "XOR 错的帧记入 rx_bad_xor");
+    Check(m->rx_frames == 1 && m->latest_temp_deci == 285, "XOR 错的帧不更新温度 (仍为 28.5 度)");
+
+    Build_Temp_Frame(f, 300);
+    f[4] ^= 0x40;   // 内容错一位，XOR 保持原值
+    Feed(m, f, sizeof(f));
+    Check(m->rx_bad_xor == 2 && m->latest_temp_deci == 285, "内容损坏的帧被 XOR 拦下");
+
+    Build_Temp_Frame(f, 300);
+    Feed(m, f, sizeof(f));
+    Check(m->rx_frames == 2 && m->rx_bad_xor == 2 && m->latest_temp_deci == 300, "坏帧之后的好帧照常解析 (30.0 度)");
+
+    return failed;
+}
@@ -0,0 +1,288 @@
+/*
+ * replay.cpp
+ * 按原始时序把抓包回放到串口 / pty，可按倍速压缩
+ * 功能：
+ * 1. 输入：嗅探日志 ([ms] Len:.. Raw: FC ..，每行一帧) 或 capture_d 的 .bin + .idx
+ *    (每条索引一批字节)。都是边读边放，内存不随文件长度增长。
+ * 2. 定时：CLOCK_MONOTONIC 绝对截止时刻，clock_nanosleep (默认) 或 timerfd，
+ *    第 i 帧截止 = 起点 + (t_i - t_0) / speed，不累积误差。时间戳倒退时 (拼接的日志、系统时间被调)
+ *    从该帧另起一段，接在前一段后面 1ms，和多个文件之间一样。
+ * 3. 每帧记录唤醒误差 (实际 - 截止)，--report 输出 CSV，结束打印 mean/p50/p99/max 和迟到帧数。
+ *    倍速放到串口带宽不够时 write() 会阻塞，后面的帧就会迟到，误差里能直接看出来。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/replay.cpp -o replay
+ * 用法：replay [--speed 10] [--timer nanosleep|timerfd] [--report err.csv] [--loop N]
+ *              (--port /dev/ttyUSB0 [--baud 115200] | --pty [--wait S] | --out 文件) 抓包...
+ */
+
+#include "capture_file.hpp"
+#include "serial_port.hpp"
+#include "sniffer_line.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// ================= 参数 =================
+struct Options {
+    double speed = 1.0;
+    bool use_timerfd = false;
+    std::string report;
+    int loops = 1;
+    std::string port;
+    int baud = 115200;
+    bool pty = false;
+    int wait_s = 2;
+    std::string out;
+    std::vector<std::string> inputs;
+};
+
+#define LATE_US        1000      // 超过 1ms 算迟到
+#define HIST_US        100000    // 误差直方图 1us 分辨率，覆盖 100ms，更大的计入溢出
+
+// ================= 输入源 =================
+// 每次给出一段字节及其原始时刻 (纳秒，同一文件内单调)
+class Source {
+public:
+    virtual ~Source() = default;
+    virtual bool next(uint64_t* t_ns, const uint8_t** data, size_t* len) = 0;
+};
+
+class SnifferSource : public Source {
+public:
+    bool open(const std::string& path) { in_.open(path); return (bool)in_; }
+    bool next(uint64_t* t_ns, const uint8_t** data, size_t* len) override {
+        std::string s;
+        while (std::getline(in_, s)) {
+            if (!parse_sniffer_line(s, &line_)) continue;
+            *t_ns = line_.t_ms * 1000000ull;
+            *data = line_.raw.data();
+            *len = line_.raw.size();
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::ifstream in_;
+    SnifferLine line_;
+};
+
+class CaptureSource : public Source {
+public:
+    bool open(const std::string& bin) { return reader_.open(bin); }
+    bool next(uint64_t* t_ns, const uint8_t** data, size_t* len) override {
+        return reader_.next(t_ns, data, len);
+    }
+
+private:
+    CaptureReader reader_;
+};
+
+static std::unique_ptr<Source> Open_Source(const std::string& path) {
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".bin") == 0) {
+        auto s = std::make_unique<CaptureSource>();
+        if (s->open(path)) return s;
+    } else {
+        auto s = std::make_unique<SnifferSource>();
+        if (s->open(path)) return s;
+    }
+    return nullptr;
+}
+
+// ================= 定时 =================
+class Timer {
+public:
+    explicit Timer(bool use_timerfd) {
+        if (use_timerfd) tfd_ = timerfd_create(CLOCK_MONOTONIC, 0);
+    }
+    ~Timer() { if (tfd_ >= 0) ::close(tfd_); }
+    bool ok(bool want_timerfd) const { return !want_timerfd || tfd_ >= 0; }
+
+    // 睡到绝对时刻 deadline (CLOCK_MONOTONIC 纳秒)，已过期立即返回
+    void sleep_until(uint64_t deadline) {
+        struct timespec ts;
+        ts.tv_sec = (time_t)(deadline / 1000000000ull);
+        ts.tv_nsec = (long)(deadline % 1000000000ull);
+        if (tfd_ >= 0) {
+            if (monotonic_ns() >= deadline) return;
+            struct itimerspec its;
+            std::memset(&its, 0, sizeof(its));
+            its.it_value = ts;
+            timerfd_settime(tfd_, TFD_TIMER_ABSTIME, &its, nullptr);
+            uint64_t expirations;
+            while (::read(tfd_, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {}
+        } else {
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+        }
+    }
+
+private:
+    int tfd_ = -1;
+};
+
+// ================= 误差统计 =================
+struct ErrStats {
+    std::vector<uint32_t> hist = std::vector<uint32_t>(HIST_US + 1, 0);
+    uint64_t n = 0, late = 0, bytes = 0;
+    double sum_us = 0.0;
+    int64_t max_us = 0;
+
+    void add(int64_t err_us) {
+        if (err_us < 0) err_us = 0;   // 绝对定时不会早醒，防御一下
+        hist[std::min<int64_t>(err_us, HIST_US)]++;
+        n++;
+        sum_us += (double)err_us;
+        max_us = std::max(max_us, err_us);
+        if (err_us > LATE_US) late++;
+    }
+    int64_t pct(double q) const {
+        uint64_t want = (uint64_t)(q * (double)n), acc = 0;
+        for (size_t i = 0; i < hist.size(); i++) {
+            acc += hist[i];
+            if (acc > want) return (int64_t)i;
+        }
+        return max_us;
+    }
+};
+
+static bool Write_All(int fd, const uint8_t* p, size_t len) {
+    while (len > 0) {
+        ssize_t w = ::write(fd, p, len);
+        if (w < 0) {
+            if (errno == EINTR || errno == EAGAIN) { usleep(100); continue; }
+            return false;
+        }
+        p += w;
+        len -= (size_t)w;
+    }
+    return true;
+}
+
+// ================= 主函数 =================
+static void Usage(void) {
+    std::fprintf(stderr,
+        "用法: replay [--speed X] [--timer nanosleep|timerfd] [--report err.csv] [--loop N]\n"
+        "             (--port 串口 [--baud B] | --pty [--wait S] | --out 文件) 抓包...\n"
+        "  抓包: 嗅探日志 (.txt) 或 capture_d 的 .bin (需同名 .idx)\n");
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--speed" && i + 1 < argc) opt.speed = std::atof(argv[++i]);
+        else if (a == "--timer" && i + 1 < argc) opt.use_timerfd = std::string(argv[++i]) == "timerfd";
+        else if (a == "--report" && i + 1 < argc) opt.report = argv[++i];
+        else if (a == "--loop" && i + 1 < argc) opt.loops = std::atoi(argv[++i]);
+        else if (a == "--port" && i + 1 < argc) opt.port = argv[++i];
+        else if (a == "--baud" && i + 1 < argc) opt.baud = std::atoi(argv[++i]);
+        else if (a == "--pty") opt.pty = true;
+        else if (a == "--wait" && i + 1 < argc) opt.wait_s = std::atoi(argv[++i]);
+        else if (a == "--out" && i + 1 < argc) opt.out = argv[++i];
+        else if (a.size() > 1 && a[0] == '-') { Usage(); return 2; }
+        else opt.inputs.push_back(a);
+    }
+    int sinks = !opt.port.empty() + (int)opt.pty + !opt.out.empty();
+    if (opt.inputs.empty() || sinks != 1 || opt.speed <= 0.0 || opt.loops < 1) {
+        Usage();
+        return 2;
+    }
+
+    int fd = -1;
+    if (!opt.port.empty()) {
+        fd = open_serial(opt.port, opt.baud);
+    } else if (opt.pty) {
+        std::string slave;
+        fd = open_pty_master(&slave);
+        if (fd >= 0) {
+            std::printf("pty: %s\n", slave.c_str());
+            std::fflush(stdout);
+            sleep((unsigned)opt.wait_s);   // 留时间给被测程序打开从端
+        }
+    } else {
+        fd = ::open(opt.out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (fd < 0) {
+        std::fprintf(stderr, "打不开输出: %s\n", std::strerror(errno));
+        return 1;
+    }
+
+    Timer timer(opt.use_timerfd);
+    if (!timer.ok(opt.use_timerfd)) {
+        std::perror("timerfd_create");
+        return 1;
+    }
+    FILE* rep = nullptr;
+    if (!opt.report.empty()) {
+        rep = std::fopen(opt.report.c_str(), "w");
+        if (!rep) {
+            std::perror(opt.report.c_str());
+            return 1;
+        }
+        std::fprintf(rep, "frame,t_sched_us,err_us,bytes\n");
+    }
+
+    ErrStats st;
+    uint64_t start = monotonic_ns() + 10000000ull;   // 10ms 后开始，让第一帧也走定时路径
+    uint64_t play_base = 0;                          // 每个文件/每轮接在上一段后面
+    for (int loop = 0; loop < opt.loops; loop++) {
+        for (const std::string& path : opt.inputs) {
+            std::unique_ptr<Source> src = Open_Source(path);
+            if (!src) {
+                std::fprintf(stderr, "打不开 %s (.bin 需要同名 .idx)\n", path.c_str());
+                return 1;
+            }
+            uint64_t t, t0 = 0, prev_t = 0, last_rel = 0;
+            const uint8_t* data;
+            size_t len;
+            bool first = true;
+            while (src->next(&t, &data, &len)) {
+                if (first) { t0 = t; first = false; }
+                // 时间倒退 (拼接的嗅探日志 [ms] 重新计数、.idx 里 CLOCK_REALTIME 被调)：
+                // 当成新的一段，和文件之间一样接在后面
+                if (t < prev_t) {
+                    std::fprintf(stderr, "%s: 第 %llu 帧时间倒退 %.3fs，从这里另起一段\n", path.c_str(),
+                                 (unsigned long long)st.n, (double)(prev_t - t) / 1e9);
+                    play_base += last_rel + 1000000ull;
+                    t0 = t;
+                }
+                prev_t = t;
+                uint64_t rel = (uint64_t)((double)(t - t0) / opt.speed);
+                last_rel = rel;
+                uint64_t deadline = start + play_base + rel;
+                timer.sleep_until(deadline);
+                int64_t err_us = ((int64_t)monotonic_ns() - (int64_t)deadline) / 1000;
+                if (!Write_All(fd, data, len)) {
+                    std::fprintf(stderr, "写失败: %s\n", std::strerror(errno));
+                    return 1;
+                }
+                st.add(err_us);
+                st.bytes += len;
+                if (rep) std::fprintf(rep, "%llu,%llu,%lld,%zu\n", (unsigned long long)(st.n - 1),
+                                      (unsigned long long)((play_base + rel) / 1000), (long long)err_us, len);
+            }
+            play_base += last_rel + 1000000ull;   // 段间隔 1ms
+        }
+    }
+    double dur = (double)(monotonic_ns() - start) / 1e9;
+
+    std::fprintf(stderr,
+        "回放 %llu 帧 %llu 字节, %.2fs (%.0f B/s), 定时误差 mean %.1fus p50 %lldus p99 %lldus max %lldus, 迟到(>%dus) %llu\n",
+        (unsigned long long)st.n, (unsigned long long)st.bytes, dur, dur > 0 ? (double)st.bytes / dur : 0.0,
+        st.n ? st.sum_us / (double)st.n : 0.0, (long long)st.pct(0.50), (long long)st.pct(0.99),
+        (long long)st.max_us, LATE_US, (unsigned long long)st.late);
+    if (rep) std::fclose(rep);
+    if (opt.pty) usleep(200000);   // 关主端前给读端一点时间
+    ::close(fd);
+    return 0;
+}
@@ -0,0 +1,530 @@
+/*
+ * trace_dec.cpp
+ * 固件调试导出的解码器：事件跟踪 (CMD 0x70)，--prof 时解性能分析表 (CMD 0x71)，
+ * --diag 时解诊断信息 (CMD 0x72)，--report 时把二进制报告 (CMD 0x73) 还原成文本报告行，
+ * --hist 时解 ADC 直方图 (CMD 0x74)
+ * 流程：
+ * 1. capture_d 抓设备输出口 (或任何原始二进制抓包)
+ * 2. 向设备发请求帧 FC 05 00 70 89，例如 printf '\xFC\x05\x00\x70\x89' > /dev/ttyUSB0
+ * 3. trace_dec 抓包.bin  -> 每次导出一段时间线
+ * 性能分析表请求帧 FC 05 00 71 88 (读后清零用 FC 06 00 71 01 8A)，用 trace_dec --prof 抓包.bin 查看。
+ * 诊断信息请求帧 FC 05 00 72 8B，用 trace_dec --diag 抓包.bin 查看。
+ * 固件用 MONITOR_FORMAT_FRAME 编译时报告是二进制帧，trace_dec --report 抓包.bin > 报告.txt 之后
+ * 可以照常交给 downsample 等按报告行工作的工具。和固件一样，只有多实例时行首才有 "S<n> "：
+ * 帧里不带实例总数，所以先扫一遍，抓包里出现过第二个及以后实例的报告才加前缀。
+ * 直方图请求帧 FC 05 00 74 8D (读后清零 FC 06 00 74 01 8F，只清零 FC 06 00 74 02 8C)，用 trace_dec --hist 查看。
+ * 事件名/区段名来自固件同一张表 miku666/H/trace_events.def、profile_zones.def，字符串只在上位机。
+ * 时间戳是 DWT 周期数，按相邻事件差值展开 32 位回绕 (相邻事件间隔需小于一个回绕周期)。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/trace_dec.cpp -o trace_dec
+ * 用法：trace_dec [--prof | --diag | --report | --hist] [--csv] 抓包.bin...
+ */
+
+#include "jrzx.hpp"
+#include "mapped_file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#define EVT_BYTES  12
+#define HDR_BYTES  10
+#define HIST_HDR_BYTES  6
+#define HIST_CODES      4096
+
+struct EventName {
+    const char* name;
+    const char* a0;
+    const char* a1;
+};
+
+static const EventName kEvents[] = {
+#define TRACE_EVENT(name, a0, a1) {#name, a0, a1},
+#include "../miku666/H/trace_events.def"
+#undef TRACE_EVENT
+};
+static const size_t kEventCount = sizeof(kEvents) / sizeof(kEvents[0]);
+
+static const char* const kZones[] = {
+#define PROF_ZONE(name) #name,
+#include "../miku666/H/profile_zones.def"
+#undef PROF_ZONE
+};
+static const size_t kZoneCount = sizeof(kZones) / sizeof(kZones[0]);
+
+struct Event {
+    uint32_t ts;
+    uint16_t id;
+    uint16_t a0;
+    uint32_t a1;
+};
+
+// 一次导出 (若干块拼起来)
+struct Dump {
+    size_t   offset = 0;      // 第一块在抓包中的偏移
+    uint32_t hz = 0;
+    uint32_t head = 0;        // 设备累计写入条数
+    unsigned chunks = 0;      // 应有块数
+    unsigned got = 0;         // 实收块数
+    std::vector<Event> events;
+};
+
+// 一次直方图导出 (若干块拼起来)，每个实例一张
+struct HistDump {
+    size_t   offset = 0;
+    unsigned chunks = 0;
+    unsigned got = 0;
+    unsigned shift = 0;       // 箱宽 = 2^shift 个码
+    std::map<unsigned, std::vector<uint32_t>> bins;
+};
+
+static uint16_t Get_U16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t Get_U32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 直方图：总样本、占用范围、范围内的空箱 (缺码)、峰数 (谷底低于较小峰一半才算分开的两个峰)
+static void Print_Hist(const HistDump& h, int no, bool csv) {
+    unsigned width = 1u << h.shift;
+    if (!csv) {
+        std::printf("# 直方图 %d @%zu: 箱宽 %u 码，块 %u/%u\n", no, h.offset, width, h.got, h.chunks);
+        if (h.chunks == 0) std::printf("# 固件未打开 MONITOR_HIST\n");
+        else if (h.got != h.chunks) std::printf("# 警告：缺块，直方图不完整\n");
+    }
+    for (const auto& kv : h.bins) {
+        const std::vector<uint32_t>& b = kv.second;
+        uint64_t total = 0;
+        size_t lo = b.size(), hi = 0, mode = 0, saturated = 0;
+        for (size_t i = 0; i < b.size(); i++) {
+            total += b[i];
+            if (b[i] == 0xFFFF) saturated++;
+            if (b[i]) {
+                if (lo == b.size()) lo = i;
+                hi = i;
+            }
+            if (b[i] > b[mode]) mode = i;
+        }
+        if (csv) {
+            for (size_t i = 0; i < b.size(); i++) {
+                if (b[i]) std::printf("%d,%u,%zu,%zu,%u\n", no, kv.first + 1, i * width, (i + 1) * width - 1, b[i]);
+            }
+            continue;
+        }
+        if (total == 0) {
+            std::printf("S%u  无样本\n", kv.first + 1);
+            continue;
+        }
+        size_t empty = 0;
+        for (size_t i = lo; i <= hi; i++) empty += b[i] == 0;
+        // 峰数在三箱滑动和上数，单个缺码箱不会把一个峰劈成两个
+        unsigned peaks = 0;
+        uint32_t peak = 0, valley = 0, top = 0;
+        bool rising = true;
+        std::vector<uint32_t> sm(b.size() + 1, 0);
+        for (size_t i = lo; i <= hi; i++) {
+            sm[i] = b[i] + (i > 0 ? b[i - 1] : 0) + (i + 1 < b.size() ? b[i + 1] : 0);
+            if (sm[i] > top) top = sm[i];
+        }
+        for (size_t i = lo; i <= hi + 1; i++) {
+            uint32_t v = i <= hi ? sm[i] : 0;
+            if (rising) {
+                if (v >= peak) peak = v;
+                else if (v * 2 < peak) { rising = false; valley = v; peaks++; }
+            } else {
+                if (v < valley) valley = v;
+                if (v > valley * 2 && v * 5 >= top) { rising = true; peak = v; }
+            }
+        }
+        if (rising && peak) peaks++;
+        std::printf("S%u  样本 %llu，码 %zu~%zu，众数箱 %zu~%zu (%u)，范围内空箱 %zu，峰 %u%s\n", kv.first + 1,
+                    (unsigned long long)total, lo * width, (hi + 1) * width - 1, mode * width, (mode + 1) * width - 1,
+                    b[mode], empty, peaks, saturated ? "，有计数到顶 (65535)" : "");
+        for (size_t i = lo; i <= hi; i++) {
+            if (!b[i]) continue;
+            int bar = (int)((uint64_t)b[i] * 50 / b[mode]);
+            std::printf("  %4zu~%-4zu %6u %.*s\n", i * width, (i + 1) * width - 1, b[i], bar,
+                        "##################################################");
+        }
+    }
+}
+
+static void Usage(void) {
+    std::fprintf(stderr, "用法: trace_dec [--prof | --diag | --report | --hist] [--csv] 抓包.bin...\n");
+}
+
+// 诊断信息：版本(1) 运行时间ms(4) 栈总字节(2) 栈最深(2) 收帧(4) XOR错(4) 串口错误(4)
+// v2 追加：实例数(1) + 每实例 [收帧(4) XOR错(4) 串口错误(4)]
+static void Print_Diag(const jrzx::Frame& f, int no, bool csv) {
+    const uint8_t* p = f.data + 4;
+    size_t body = f.len - jrzx::MIN_LEN;
+    if (body < 21) return;
+    unsigned ver = p[0];
+    uint32_t up = Get_U32(p + 1);
+    unsigned stack_size = Get_U16(p + 5), stack_peak = Get_U16(p + 7);
+    uint32_t frames = Get_U32(p + 9), bad = Get_U32(p + 13), uart_err = Get_U32(p + 17);
+    if (csv) {
+        std::printf("%d,%u,%u,%u,%u,%u,%u,%u\n", no, ver, up, stack_size, stack_peak, frames, bad, uart_err);
+        return;
+    }
+    std::printf("# 诊断 %d @%zu (格式 v%u)\n", no, f.offset, ver);
+    std::printf("运行时间   %.3f s\n", up / 1000.0);
+    std::printf("栈         最深 %u / %u 字节 (剩余 %u)\n", stack_peak, stack_size,
+                stack_size > stack_peak ? stack_size - stack_peak : 0);
+    std::printf("收帧       %u 正确，%u XOR 错\n", frames, bad);
+    std::printf("串口错误   %u\n", uart_err);
+    if (ver < 2 || body < 22) return;
+    unsigned n = p[21];
+    if (n < 2 || body < 22 + (size_t)n * 12) return;
+    for (unsigned i = 0; i < n; i++) {
+        const uint8_t* q = p + 22 + i * 12;
+        std::printf("  S%u       收帧 %u，XOR 错 %u，串口错误 %u\n", i + 1, Get_U32(q), Get_U32(q + 4), Get_U32(q + 8));
+    }
+}
+
+// 报告：标志(1) 实例(1) 相对时间0.01s(4) 温度0.1度(2) ADC(2) [帧序号(2)，标志 bit0]
+//       [窗口统计，标志 bit1：ADC、温度各 个数(2) 最小(2) 最大(2) 均值x10(4) 标准差x10(2)]
+//       [压掉的窗口数(2)，标志 bit2]
+//       [延迟 ms(2) 相关系数%(1)，标志 bit3]
+//       [预测稳态温度 0.1度(2) 时间常数 ms(2)，标志 bit4]
+//       [对齐：对数(1) 过期个数(1) ADC 均值x10(2) 温度均值 0.01度(2)，标志 bit5]
+//       [漂移：拟合帧数(2) 帧周期 us(4) ppm x10(4) 抖动 us(2) 截断帧数(2)，标志 bit6]
+//       [热电偶：温度 0.1度(2) 故障位(1)，标志 bit7]
+#define REPORT_HAS_MARK   0x01
+#define REPORT_HAS_STATS  0x02
+#define REPORT_HAS_SUP    0x04
+#define REPORT_HAS_LAG    0x08
+#define REPORT_HAS_PREDICT 0x10
+#define REPORT_HAS_ALIGN  0x20
+#define REPORT_HAS_DRIFT  0x40
+#define REPORT_HAS_TC     0x80
+#define STATS_BYTES       12
+
+struct WinStat {
+    unsigned n;
+    int min, max;
+    int32_t mean10;
+    unsigned sd10;
+};
+
+static WinStat Get_Stats(const uint8_t* q) {
+    WinStat s;
+    s.n = Get_U16(q);
+    s.min = (int16_t)Get_U16(q + 2);
+    s.max = (int16_t)Get_U16(q + 4);
+    s.mean10 = (int32_t)Get_U32(q + 6);
+    s.sd10 = Get_U16(q + 10);
+    return s;
+}
+
+static void Print_Report(const jrzx::Frame& f, int no, bool csv, bool tag) {
+    const uint8_t* p = f.data + 4;
+    size_t body = f.len - jrzx::MIN_LEN;
+    if (body < 10) return;
+    unsigned flags = p[0], sensor = p[1];
+    int32_t t_cs = (int32_t)Get_U32(p + 2);
+    int temp = (int16_t)Get_U16(p + 6);
+    unsigned adc = Get_U16(p + 8);
+    long mark = -1;
+    size_t k = 10;
+    if (flags & REPORT_HAS_MARK) {
+        if (body < k + 2) return;
+        mark = Get_U16(p + k);
+        k += 2;
+    }
+    bool stats = (flags & REPORT_HAS_STATS) != 0;
+    WinStat as = {}, ts = {};
+    if (stats) {
+        if (body < k + 2 * STATS_BYTES) return;
+        as = Get_Stats(p + k);
+        ts = Get_Stats(p + k + STATS_BYTES);
+        k += 2 * STATS_BYTES;
+    }
+    long sup = -1;
+    if (flags & REPORT_HAS_SUP) {
+        if (body < k + 2) return;
+        sup = Get_U16(p + k);
+        k += 2;
+    }
+    bool lag = (flags & REPORT_HAS_LAG) != 0;
+    int lag_ms = 0, lag_rho = 0;
+    if (lag) {
+        if (body < k + 3) return;
+        lag_ms = (int16_t)Get_U16(p + k);
+        lag_rho = (int8_t)p[k + 2];
+        k += 3;
+    }
+    bool pred = (flags & REPORT_HAS_PREDICT) != 0;
+    int pred_deci = 0;
+    unsigned tau_ms = 0;
+    if (pred) {
+        if (body < k + 4) return;
+        pred_deci = (int16_t)Get_U16(p + k);
+        tau_ms = Get_U16(p + k + 2);
+        k += 4;
+    }
+    bool align = (flags & REPORT_HAS_ALIGN) != 0;
+    unsigned al_n = 0, al_stale = 0, al_adc10 = 0;
+    int al_temp = 0;
+    if (align) {
+        if (body < k + 6) return;
+        al_n = p[k];
+        al_stale = p[k + 1];
+        al_adc10 = Get_U16(p + k + 2);
+        al_temp = (int16_t)Get_U16(p + k + 4);
+        k += 6;
+    }
+    bool drift = (flags & REPORT_HAS_DRIFT) != 0;
+    unsigned dr_n = 0, dr_jit = 0, dr_out = 0;
+    uint32_t dr_period = 0;
+    int32_t dr_ppm10 = 0;
+    if (drift) {
+        if (body < k + 14) return;
+        dr_n = Get_U16(p + k);
+        dr_period = Get_U32(p + k + 2);
+        dr_ppm10 = (int32_t)Get_U32(p + k + 6);
+        dr_jit = Get_U16(p + k + 10);
+        dr_out = Get_U16(p + k + 12);
+        k += 14;
+    }
+    bool tc = (flags & REPORT_HAS_TC) != 0;
+    int tc_deci = 0;
+    unsigned tc_fault = 0;
+    if (tc) {
+        if (body < k + 3) return;
+        tc_deci = (int16_t)Get_U16(p + k);
+        tc_fault = p[k + 2];
+        k += 3;
+    }
+    if (csv) {
+        std::printf("%d,%u,%.2f,%.1f,%u,%ld", no, sensor + 1, t_cs / 100.0, temp / 10.0, adc, mark);
+        if (stats) {
+            std::printf(",%u,%d,%d,%.1f,%.1f,%u,%.1f,%.1f,%.2f,%.2f", as.n, as.min, as.max, as.mean10 / 10.0,
+                        as.sd10 / 10.0, ts.n, ts.min / 10.0, ts.max / 10.0, ts.mean10 / 100.0, ts.sd10 / 100.0);
+        } else {
+            std::printf(",,,,,,,,,,");
+        }
+        std::printf(",%ld", sup);
+        if (lag) std::printf(",%d,%d", lag_ms, lag_rho);
+        else std::printf(",,");
+        if (pred) std::printf(",%.1f,%u", pred_deci / 10.0, tau_ms);
+        else std::printf(",,");
+        if (align) std::printf(",%u,%.1f,%.2f,%u", al_n, al_adc10 / 10.0, al_temp / 100.0, al_stale);
+        else std::printf(",,,,");
+        if (drift) std::printf(",%u,%u,%.1f,%u,%u", dr_n, (unsigned)dr_period, dr_ppm10 / 10.0, dr_jit, dr_out);
+        else std::printf(",,,,,");
+        if (tc) std::printf(",%.1f,%u\n", tc_deci / 10.0, tc_fault);
+        else std::printf(",,\n");
+        return;
+    }
+    // 与固件文本报告行同格式
+    unsigned abs_cs = (unsigned)(t_cs < 0 ? -t_cs : t_cs);
+    if (tag) std::printf("S%u ", sensor + 1);
+    std::printf("[%s%u.%02us] T:%d.%d C, ADC:%u", t_cs < 0 ? "-" : "", abs_cs / 100, abs_cs % 100, temp / 10,
+                temp % 10, adc);
+    if (mark >= 0) std::printf(", M:%ld", mark);
+    if (stats) {
+        std::printf(", AS:%u/%d/%d/%.1f/%.1f, TS:%u/%.1f/%.1f/%.2f/%.2f", as.n, as.min, as.max, as.mean10 / 10.0,
+                    as.sd10 / 10.0, ts.n, ts.min / 10.0, ts.max / 10.0, ts.mean10 / 100.0, ts.sd10 / 100.0);
+    }
+    if (pred) std::printf(", PT:%.1f C, TAU:%u", pred_deci / 10.0, tau_ms);
+    if (lag) std::printf(", LAG:%d/%d", lag_ms, lag_rho);
+    if (align) std::printf(", AL:%u/%.1f/%.2f/%u", al_n, al_adc10 / 10.0, al_temp / 100.0, al_stale);
+    if (drift) std::printf(", DR:%u/%u/%.1f/%u/%u", dr_n, (unsigned)dr_period, dr_ppm10 / 10.0, dr_jit, dr_out);
+    if (tc) std::printf(", TC:%.1f/%u", tc_deci / 10.0, tc_fault);
+    if (sup >= 0) std::printf(", SUP:%ld", sup);
+    std::printf("\n");
+}
+
+// 性能分析表：时钟(4) 开销(4) 区段数(1) + 区段 x N [次数 最小 最大 总周期(8)]
+static void Print_Profile(const jrzx::Frame& f, int no, bool csv) {
+    const uint8_t* p = f.data + 4;
+    size_t body = f.len - jrzx::MIN_LEN;
+    uint32_t hz = Get_U32(p);
+    uint32_t overhead = Get_U32(p + 4);
+    unsigned zones = p[8];
+    if (body < 9 + (size_t)zones * 20) return;
+    double us_per_cycle = hz ? 1e6 / (double)hz : 1.0;
+    if (!csv) {
+        std::printf("# 性能表 %d @%zu: %u 区段，%u Hz，计时开销 %u 周期 (已扣除)\n", no, f.offset, zones, hz, overhead);
+        if (zones == 0) std::printf("# 固件未打开 MONITOR_PROFILE\n");
+        else std::printf("%-12s %10s %10s %10s %12s %12s\n", "zone", "count", "min", "max", "mean", "total_ms");
+    }
+    for (unsigned z = 0; z < zones; z++) {
+        const uint8_t* q = p + 9 + z * 20;
+        uint32_t count = Get_U32(q), mn = Get_U32(q + 4), mx = Get_U32(q + 8);
+        uint64_t total = (uint64_t)Get_U32(q + 12) | ((uint64_t)Get_U32(q + 16) << 32);
+        double mean = count ? (double)total / (double)count : 0.0;
+        const char* name = z < kZoneCount ? kZones[z] : "?";
+        if (csv) {
+            std::printf("%d,%s,%u,%u,%u,%.1f,%llu\n", no, name, count, mn, mx, mean, (unsigned long long)total);
+        } else {
+            std::printf("%-12s %10u %10u %10u %12.1f %12.3f\n", name, count, mn, mx, mean,
+                        (double)total * us_per_cycle / 1000.0);
+        }
+    }
+}
+
+static void Print_Dump(const Dump& d, int no, bool csv) {
+    size_t n = d.events.size();
+    if (!csv) {
+        std::printf("# 导出 %d @%zu: %zu 条 (累计 %u，覆盖 %u)，块 %u/%u，%u Hz\n",
+                    no, d.offset, n, d.head, d.head > n ? d.head - (uint32_t)n : 0,
+                    d.got, d.chunks, d.hz);
+        if (d.got != d.chunks) std::printf("# 警告：缺块，时间线不完整\n");
+        std::printf("%12s %10s  %-13s %s\n", "t_us", "dt_us", "event", "args");
+    }
+    double us_per_cycle = d.hz ? 1e6 / (double)d.hz : 1.0;
+    uint64_t t = 0;
+    for (size_t i = 0; i < n; i++) {
+        const Event& e = d.events[i];
+        uint32_t dt = i ? (uint32_t)(e.ts - d.events[i - 1].ts) : 0;
+        t += dt;
+        const char* name = e.id < kEventCount ? kEvents[e.id].name : "?";
+        const char* a0 = e.id < kEventCount ? kEvents[e.id].a0 : "a0";
+        const char* a1 = e.id < kEventCount ? kEvents[e.id].a1 : "a1";
+        if (csv) {
+            std::printf("%d,%.3f,%.3f,%s,%u,%u\n", no, (double)t * us_per_cycle, (double)dt * us_per_cycle,
+                        name, e.a0, e.a1);
+        } else {
+            std::printf("%12.3f %10.3f  %-13s %s=%u %s=%u\n", (double)t * us_per_cycle, (double)dt * us_per_cycle,
+                        name, a0, e.a0, a1, e.a1);
+        }
+    }
+}
+
+// 抓包里有没有第二个及以后实例的报告 (固件 MONITOR_INSTANCES > 1 时文本行才带 "S<n> ")
+static bool Multi_Instance(const std::vector<std::string>& files) {
+    bool multi = false;
+    for (const std::string& path : files) {
+        MappedFile mf;
+        if (!mf.open(path)) continue;   // 打不开的留给主循环报错
+        jrzx::scan_frames(mf.data(), mf.size(), jrzx::Impl::Auto, [&](const jrzx::Frame& f) {
+            if (f.cmd == jrzx::CMD_REPORT && f.len >= jrzx::MIN_LEN + 10 && f.data[5] != 0) multi = true;
+        });
+        if (multi) break;
+    }
+    return multi;
+}
+
+int main(int argc, char** argv) {
+    bool csv = false, prof = false, diag = false, report = false, hist = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--csv") csv = true;
+        else if (a == "--prof") prof = true;
+        else if (a == "--diag") diag = true;
+        else if (a == "--report") report = true;
+        else if (a == "--hist") hist = true;
+        else if (a.size() > 1 && a[0] == '-') { Usage(); return 2; }
+        else files.push_back(a);
+    }
+    if (files.empty()) {
+        Usage();
+        return 2;
+    }
+
+    if (prof + diag + report + hist > 1) {
+        Usage();
+        return 2;
+    }
+    if (csv) {
+        std::printf(prof ? "table,zone,count,min,max,mean,total\n"
+                  : diag ? "diag,version,uptime_ms,stack_size,stack_peak,rx_frames,rx_bad_xor,uart_errors\n"
+                  : hist ? "hist,sensor,code_lo,code_hi,count\n"
+                  : report ? "report,sensor,t_s,temp_c,adc,mark,adc_n,adc_min,adc_max,adc_mean,adc_sd,"
+                             "temp_n,temp_min,temp_max,temp_mean,temp_sd,suppressed,lag_ms,lag_rho,pred_c,tau_ms,"
+                             "align_n,align_adc,align_temp,align_stale,drift_n,period_us,drift_ppm,jitter_us,"
+                             "drift_outliers,tc_c,tc_fault\n"
+                         : "dump,t_us,dt_us,event,a0,a1\n");
+    }
+    bool tag = report && !csv && Multi_Instance(files);
+    int no = 0;
+    for (const std::string& path : files) {
+        MappedFile mf;
+        if (!mf.open(path)) {
+            std::perror(path.c_str());
+            return 1;
+        }
+        Dump cur;
+        HistDump hcur;
+        bool open = false;
+        jrzx::scan_frames(mf.data(), mf.size(), jrzx::Impl::Auto, [&](const jrzx::Frame& f) {
+            if (diag) {
+                if (f.cmd == jrzx::CMD_DIAG) Print_Diag(f, ++no, csv);
+                return;
+            }
+            if (hist) {
+                if (f.cmd != jrzx::CMD_HIST || f.len < jrzx::MIN_LEN + HIST_HDR_BYTES) return;
+                const uint8_t* p = f.data + 4;
+                size_t body = f.len - jrzx::MIN_LEN;
+                // 块 0 开始新的一次导出
+                if (p[0] == 0) {
+                    if (open) Print_Hist(hcur, ++no, csv);
+                    hcur = HistDump();
+                    hcur.offset = f.offset;
+                    hcur.chunks = p[1];
+                    hcur.shift = p[3];
+                    open = true;
+                } else if (!open) {
+                    return;
+                }
+                hcur.got++;
+                if (hcur.chunks == 0 || hcur.shift > 12) return;
+                std::vector<uint32_t>& b = hcur.bins[p[2]];
+                b.resize(HIST_CODES >> hcur.shift);
+                size_t first = Get_U16(p + 4);
+                for (size_t k = HIST_HDR_BYTES, i = first; k + 2 <= body && i < b.size(); k += 2, i++) {
+                    b[i] = Get_U16(p + k);
+                }
+                return;
+            }
+            if (report) {
+                if (f.cmd == jrzx::CMD_REPORT) Print_Report(f, ++no, csv, tag);
+                return;
+            }
+            if (prof) {
+                if (f.cmd == jrzx::CMD_PROFILE && f.len >= jrzx::MIN_LEN + 9) Print_Profile(f, ++no, csv);
+                return;
+            }
+            if (f.cmd != jrzx::CMD_TRACE || f.len < jrzx::MIN_LEN + HDR_BYTES) return;
+            const uint8_t* p = f.data + 4;
+            size_t body = f.len - jrzx::MIN_LEN;
+            unsigned chunk = p[0];
+            // 块 0 开始新的一次导出
+            if (chunk == 0) {
+                if (open) Print_Dump(cur, ++no, csv);
+                cur = Dump();
+                cur.offset = f.offset;
+                cur.chunks = p[1];
+                cur.hz = Get_U32(p + 2);
+                cur.head = Get_U32(p + 6);
+                open = true;
+            } else if (!open) {
+                return;   // 抓包从导出中间开始，丢掉残块
+            }
+            cur.got++;
+            for (size_t k = HDR_BYTES; k + EVT_BYTES <= body; k += EVT_BYTES) {
+                Event e;
+                e.ts = Get_U32(p + k);
+                e.id = Get_U16(p + k + 4);
+                e.a0 = Get_U16(p + k + 6);
+                e.a1 = Get_U32(p + k + 8);
+                cur.events.push_back(e);
+            }
+        });
+        if (open) {
+            if (hist) Print_Hist(hcur, ++no, csv);
+            else Print_Dump(cur, ++no, csv);
+        }
+    }
+    if (no == 0) {
+        std::fprintf(stderr, "没有找到%s帧 (CMD 0x%02X)\n",
+                     prof ? "性能分析表" : diag ? "诊断信息" : report ? "报告" : hist ? "直方图" : "跟踪导出",
+                     prof ? jrzx::CMD_PROFILE : diag ? jrzx::CMD_DIAG : report ? jrzx::CMD_REPORT
+                          : hist ? jrzx::CMD_HIST : jrzx::CMD_TRACE);
+    }
+    return no ? 0 : 1;
+}
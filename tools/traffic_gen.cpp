@@ -0,0 +1,409 @@
+/*
+ * traffic_gen.cpp
+ * JRZX 流量发生器 (带故障注入)，用于解析器压力测试
+ * 功能：
+ * 1. 按比例生成：0x01 温度应答 (FC 0A 00 01 ..，帧后带一个 00，同 实际数据.txt)、
+ *    FC 05 00 01 请求、不支持的 CMD、IAP 包 (E0/E1/E2/E3)。
+ * 2. 每帧按概率注入故障：位翻转、丢字节、截断 (Len:5 T:Err 那种)、重复帧头、XOR 错。
+ * 3. 输出到文件 / pty / 串口；默认按波特率满速发送 (绝对截止时刻)，文件输出默认不限速。
+ * 4. 同时写真值清单 CSV：序号、流内偏移、长度、类型、CMD、温度、注入的故障、是否仍是有效帧。
+ * 5. --mark：温度帧的第二个温度字换成温度帧序号 (低 16 位)，配合固件 MONITOR_LATENCY_MARK
+ *    和 latency 工具测端到端延迟；--interval MS 按固定帧间隔发 (模拟传感器节奏) 而不是满速。
+ * 6. --score 清单 抓包.bin：用 jrzx_scan 同款扫描器扫抓包，按偏移对真值，输出恢复率
+ *    (找回的有效帧 / 发出的有效帧) 和误识别帧数。要求抓包与发出的字节流逐字节对应
+ *    (文件输出或 pty 环回)。
+ *
+ * 编译：g++ -O2 -std=c++17 -Itools/common tools/traffic_gen.cpp -o traffic_gen
+ * 用法：traffic_gen [--count N] [--seed S] [--mix temp=50,req=45,unsup=2,iap=3]
+ *                   [--flip P] [--drop P] [--trunc P] [--dup-head P] [--bad-xor P]
+ *                   [--mark] [--interval MS]
+ *                   [--baud 115200] [--pace] --manifest m.csv (--out f.bin | --pty [--wait S] | --port 串口)
+ *       traffic_gen --score m.csv 抓包.bin
+ */
+
+#include "capture_file.hpp"
+#include "jrzx.hpp"
+#include "serial_port.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ================= 参数 =================
+enum FrameType { FT_TEMP, FT_REQ, FT_UNSUP, FT_IAP, FT_COUNT };
+static const char* const kTypeName[FT_COUNT] = {"temp", "req", "unsup", "iap"};
+
+enum Fault {
+    F_FLIP     = 1 << 0,
+    F_DROP     = 1 << 1,
+    F_TRUNC    = 1 << 2,
+    F_DUP_HEAD = 1 << 3,
+    F_BAD_XOR  = 1 << 4,
+};
+
+struct Options {
+    uint64_t count = 100000;
+    uint32_t seed = 1;
+    double mix[FT_COUNT] = {50, 45, 2, 3};
+    double p_flip = 0, p_drop = 0, p_trunc = 0, p_dup = 0, p_xor = 0;
+    int baud = 115200;
+    bool pace = false;
+    bool mark = false;
+    double interval_ms = 0;          // >0: 按固定帧间隔发
+    std::string manifest;
+    std::string out, port;
+    bool pty = false;
+    int wait_s = 2;
+    std::string score_manifest, score_capture;
+};
+
+#define IAP_PACKET_SIZE  128
+#define TEMP_MIN_DECI    150
+#define TEMP_MAX_DECI    450
+
+// ================= 帧生成 =================
+class Generator {
+public:
+    explicit Generator(const Options& opt) : opt_(opt), rng_(opt.seed) {
+        double sum = 0;
+        for (double m : opt.mix) sum += m;
+        double acc = 0;
+        for (int i = 0; i < FT_COUNT; i++) {
+            acc += opt.mix[i] / (sum > 0 ? sum : 1);
+            cdf_[i] = acc;
+        }
+    }
+
+    // 生成一帧 (未注入故障)，返回类型
+    FrameType make(std::vector<uint8_t>* f, uint8_t* cmd, int* temp_deci) {
+        double r = uni_(rng_);
+        FrameType t = FT_IAP;
+        for (int i = 0; i < FT_COUNT; i++) if (r < cdf_[i]) { t = (FrameType)i; break; }
+        uint8_t buf[jrzx::MAX_LEN];
+        uint8_t pl[IAP_PACKET_SIZE + 8];
+        size_t n = 0;
+        *temp_deci = -1;
+        switch (t) {
+            case FT_TEMP: {
+                // 温度随机游走
+                temp_ += (int)(rng_() % 5) - 2;
+                if (temp_ < TEMP_MIN_DECI) temp_ = TEMP_MIN_DECI;
+                if (temp_ > TEMP_MAX_DECI) temp_ = TEMP_MAX_DECI;
+                int t2 = opt_.mark ? (int)(temp_seq_ & 0xFFFF) : temp_ - 1;
+                temp_seq_++;
+                pl[0] = (uint8_t)temp_; pl[1] = (uint8_t)(temp_ >> 8);
+                pl[2] = (uint8_t)t2;    pl[3] = (uint8_t)(t2 >> 8);
+                pl[4] = 0x00;
+                n = jrzx::build_frame(buf, jrzx::CMD_TEMP, pl, 5);
+                *temp_deci = temp_;
+                break;
+            }
+            case FT_REQ:
+                n = jrzx::build_frame(buf, jrzx::CMD_TEMP, nullptr, 0);
+                break;
+            case FT_UNSUP: {
+                static const uint8_t kCmds[] = {0x05, 0x10, 0x20, 0x7A, 0x99, jrzx::CMD_UNSUP};
+                uint8_t c = kCmds[rng_() % sizeof(kCmds)];
+                size_t pn = rng_() % 6;
+                for (size_t i = 0; i < pn; i++) pl[i] = (uint8_t)rng_();
+                n = jrzx::build_frame(buf, c, pl, pn);
+                break;
+            }
+            case FT_IAP:
+            default:
+                n = Make_Iap(buf, pl);
+                break;
+        }
+        f->assign(buf, buf + n);
+        *cmd = buf[3];
+        return t;
+    }
+
+    // 按概率注入故障，返回故障位；截断/丢字节会改变长度
+    unsigned inject(std::vector<uint8_t>* f) {
+        unsigned faults = 0;
+        if (hit(opt_.p_xor)) {
+            f->back() ^= (uint8_t)(1 + rng_() % 255);
+            faults |= F_BAD_XOR;
+        }
+        if (hit(opt_.p_flip)) {
+            size_t i = rng_() % f->size();
+            (*f)[i] ^= (uint8_t)(1u << (rng_() % 8));
+            faults |= F_FLIP;
+        }
+        if (hit(opt_.p_drop) && f->size() > 1) {
+            f->erase(f->begin() + (long)(rng_() % f->size()));
+            faults |= F_DROP;
+        }
+        if (hit(opt_.p_trunc) && f->size() > 1) {
+            f->resize(1 + rng_() % (f->size() - 1));
+            faults |= F_TRUNC;
+        }
+        if (hit(opt_.p_dup)) {
+            // 先发一段残缺的帧头 (FC 或 FC 0A)，再发整帧
+            size_t k = 1 + rng_() % 2;
+            f->insert(f->begin(), f->begin(), f->begin() + (long)std::min(k, f->size()));
+            faults |= F_DUP_HEAD;
+        }
+        return faults;
+    }
+
+private:
+    bool hit(double p) { return p > 0 && uni_(rng_) < p; }
+
+    size_t Make_Iap(uint8_t* buf, uint8_t* pl) {
+        switch (iap_step_) {
+            case 0:
+                iap_step_ = 1;
+                return jrzx::build_frame(buf, jrzx::CMD_IAP_VER, nullptr, 0);
+            case 1: {
+                uint32_t size = IAP_PACKET_SIZE * 4;
+                pl[0] = (uint8_t)size; pl[1] = (uint8_t)(size >> 8);
+                pl[2] = (uint8_t)(size >> 16); pl[3] = (uint8_t)(size >> 24);
+                pl[4] = IAP_PACKET_SIZE;
+                pl[5] = 4; pl[6] = 0;
+                iap_step_ = 2;
+                iap_idx_ = 0;
+                return jrzx::build_frame(buf, jrzx::CMD_IAP_INF, pl, 7);
+            }
+            case 2: {
+                pl[0] = (uint8_t)iap_idx_; pl[1] = (uint8_t)(iap_idx_ >> 8);
+                for (size_t i = 0; i < IAP_PACKET_SIZE; i++) pl[2 + i] = (uint8_t)rng_();
+                if (++iap_idx_ >= 4) iap_step_ = 3;
+                return jrzx::build_frame(buf, jrzx::CMD_IAP_DAT, pl, 2 + IAP_PACKET_SIZE);
+            }
+            default:
+                iap_step_ = 0;
+                return jrzx::build_frame(buf, jrzx::CMD_IAP_END, nullptr, 0);
+        }
+    }
+
+    const Options& opt_;
+    std::mt19937 rng_;
+    std::uniform_real_distribution<double> uni_{0.0, 1.0};
+    double cdf_[FT_COUNT];
+    int temp_ = 285;
+    uint32_t temp_seq_ = 0;
+    int iap_step_ = 0;
+    uint16_t iap_idx_ = 0;
+};
+
+// ================= 输出 =================
+static bool Write_All(int fd, const uint8_t* p, size_t len) {
+    while (len > 0) {
+        ssize_t w = ::write(fd, p, len);
+        if (w < 0) {
+            if (errno == EINTR || errno == EAGAIN) { usleep(100); continue; }
+            return false;
+        }
+        p += w;
+        len -= (size_t)w;
+    }
+    return true;
+}
+
+static void Faults_Str(unsigned f, char* s, size_t n) {
+    s[0] = '\0';
+    static const char* const names[] = {"flip", "drop", "trunc", "dup_head", "bad_xor"};
+    for (int i = 0; i < 5; i++) {
+        if (!(f & (1u << i))) continue;
+        if (s[0]) std::strncat(s, "|", n - std::strlen(s) - 1);
+        std::strncat(s, names[i], n - std::strlen(s) - 1);
+    }
+    if (!s[0]) std::strncat(s, "-", n - 1);
+}
+
+static int Run_Generate(const Options& opt) {
+    int fd = -1;
+    if (!opt.out.empty()) {
+        fd = ::open(opt.out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    } else if (opt.pty) {
+        std::string slave;
+        fd = open_pty_master(&slave);
+        if (fd >= 0) {
+            std::printf("pty: %s\n", slave.c_str());
+            std::fflush(stdout);
+            sleep((unsigned)opt.wait_s);
+        }
+    } else {
+        fd = open_serial(opt.port, opt.baud);
+    }
+    if (fd < 0) {
+        std::fprintf(stderr, "打不开输出: %s\n", std::strerror(errno));
+        return 1;
+    }
+    FILE* man = std::fopen(opt.manifest.c_str(), "w");
+    if (!man) {
+        std::perror(opt.manifest.c_str());
+        return 1;
+    }
+    std::fprintf(man, "seq,offset,len,type,cmd,temp_deci,faults,valid,t_ns,mark\n");
+
+    // 串口/pty 默认满速限速，文件默认不限速
+    bool pace = opt.pace || opt.out.empty() || opt.interval_ms > 0;
+    const double ns_per_byte = 1e10 / (double)opt.baud;   // 10 bit/字节
+    Generator gen(opt);
+    std::vector<uint8_t> f;
+    uint64_t offset = 0, valid = 0;
+    uint32_t temp_seq = 0;
+    uint64_t start = monotonic_ns();
+    for (uint64_t seq = 0; seq < opt.count; seq++) {
+        uint8_t cmd;
+        int temp;
+        FrameType t = gen.make(&f, &cmd, &temp);
+        unsigned faults = gen.inject(&f);
+        if (t == FT_TEMP) f.push_back(0x00);   // 真实传感器帧后多一个 00
+
+        // 注入后的字节在偏移 offset 处能否按协议通过校验 (重复帧头时真帧往后挪)
+        size_t head_skip = (faults & F_DUP_HEAD) ? (size_t)(f.size() > 1 && f[1] == jrzx::HEAD ? 1 : 2) : 0;
+        size_t vlen = head_skip < f.size() ? jrzx::validate_at(f.data() + head_skip, f.size() - head_skip, 0) : 0;
+        if (vlen) valid++;
+
+        if (pace) {
+            uint64_t deadline = opt.interval_ms > 0
+                ? start + (uint64_t)((double)seq * opt.interval_ms * 1e6)
+                : start + (uint64_t)((double)offset * ns_per_byte);
+            struct timespec ts = {(time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull)};
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+        }
+        uint64_t t_ns = realtime_ns();
+        if (!Write_All(fd, f.data(), f.size())) {
+            std::fprintf(stderr, "写失败: %s\n", std::strerror(errno));
+            return 1;
+        }
+        char fs[64];
+        Faults_Str(faults, fs, sizeof(fs));
+        int mark = -1;
+        if (t == FT_TEMP) {
+            if (opt.mark) mark = (int)(temp_seq & 0xFFFF);
+            temp_seq++;
+        }
+        std::fprintf(man, "%llu,%llu,%zu,%s,%02X,%d,%s,%d,%llu,%d\n",
+                     (unsigned long long)seq, (unsigned long long)(offset + head_skip),
+                     vlen ? vlen : f.size(), kTypeName[t], cmd, temp, fs, vlen ? 1 : 0,
+                     (unsigned long long)t_ns, mark);
+        offset += f.size();
+    }
+    double sec = (double)(monotonic_ns() - start) / 1e9;
+    std::fprintf(stderr, "发出 %llu 帧 (有效 %llu) %llu 字节, %.2fs, %.0f B/s\n",
+                 (unsigned long long)opt.count, (unsigned long long)valid, (unsigned long long)offset,
+                 sec, sec > 0 ? (double)offset / sec : 0.0);
+    std::fclose(man);
+    if (opt.pty) usleep(200000);
+    ::close(fd);
+    return 0;
+}
+
+// ================= 打分 =================
+static int Run_Score(const Options& opt) {
+    FILE* man = std::fopen(opt.score_manifest.c_str(), "r");
+    if (!man) {
+        std::perror(opt.score_manifest.c_str());
+        return 1;
+    }
+    // 偏移 -> 有效帧长
+    std::unordered_map<uint64_t, size_t> truth;
+    char line[512];
+    uint64_t sent_valid = 0;
+    std::fgets(line, sizeof(line), man);   // 表头
+    while (std::fgets(line, sizeof(line), man)) {
+        unsigned long long seq, off;
+        size_t len;
+        char type[16], cmd[8], faults[64];
+        int temp, valid;
+        if (std::sscanf(line, "%llu,%llu,%zu,%15[^,],%7[^,],%d,%63[^,],%d", &seq, &off, &len, type, cmd,
+                        &temp, faults, &valid) != 8) continue;
+        if (valid) {
+            truth[off] = len;
+            sent_valid++;
+        }
+    }
+    std::fclose(man);
+
+    MappedFile cap;
+    if (!cap.open(opt.score_capture)) {
+        std::perror(opt.score_capture.c_str());
+        return 1;
+    }
+    uint64_t found = 0, recovered = 0, spurious = 0;
+    jrzx::scan_frames(cap.data(), cap.size(), jrzx::Impl::Auto, [&](const jrzx::Frame& fr) {
+        found++;
+        auto it = truth.find(fr.offset);
+        if (it != truth.end() && it->second == fr.len) recovered++;
+        else spurious++;
+    });
+    std::printf("有效帧 发出 %llu, 扫到 %llu, 找回 %llu, 误识别 %llu, 恢复率 %.4f\n",
+                (unsigned long long)sent_valid, (unsigned long long)found, (unsigned long long)recovered,
+                (unsigned long long)spurious, sent_valid ? (double)recovered / (double)sent_valid : 0.0);
+    return 0;
+}
+
+// ================= 主函数 =================
+static void Usage(void) {
+    std::fprintf(stderr,
+        "用法: traffic_gen [--count N] [--seed S] [--mix temp=50,req=45,unsup=2,iap=3]\n"
+        "                  [--flip P] [--drop P] [--trunc P] [--dup-head P] [--bad-xor P]\n"
+        "                  [--mark] [--interval MS]\n"
+        "                  [--baud B] [--pace] --manifest m.csv (--out f.bin | --pty [--wait S] | --port 串口)\n"
+        "      traffic_gen --score m.csv 抓包.bin\n");
+}
+
+// 没写到的类型比例为 0
+static bool Parse_Mix(const std::string& s, double* mix) {
+    for (int i = 0; i < FT_COUNT; i++) mix[i] = 0;
+    size_t p = 0;
+    while (p < s.size()) {
+        size_t q = s.find(',', p);
+        std::string kv = s.substr(p, q == std::string::npos ? std::string::npos : q - p);
+        size_t eq = kv.find('=');
+        if (eq == std::string::npos) return false;
+        std::string k = kv.substr(0, eq);
+        int i = 0;
+        while (i < FT_COUNT && k != kTypeName[i]) i++;
+        if (i == FT_COUNT) return false;
+        mix[i] = std::atof(kv.c_str() + eq + 1);
+        if (q == std::string::npos) break;
+        p = q + 1;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool more = i + 1 < argc;
+        if (a == "--count" && more) opt.count = (uint64_t)std::atoll(argv[++i]);
+        else if (a == "--seed" && more) opt.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else if (a == "--mix" && more) { if (!Parse_Mix(argv[++i], opt.mix)) { Usage(); return 2; } }
+        else if (a == "--flip" && more) opt.p_flip = std::atof(argv[++i]);
+        else if (a == "--drop" && more) opt.p_drop = std::atof(argv[++i]);
+        else if (a == "--trunc" && more) opt.p_trunc = std::atof(argv[++i]);
+        else if (a == "--dup-head" && more) opt.p_dup = std::atof(argv[++i]);
+        else if (a == "--bad-xor" && more) opt.p_xor = std::atof(argv[++i]);
+        else if (a == "--baud" && more) opt.baud = std::atoi(argv[++i]);
+        else if (a == "--pace") opt.pace = true;
+        else if (a == "--mark") opt.mark = true;
+        else if (a == "--interval" && more) opt.interval_ms = std::atof(argv[++i]);
+        else if (a == "--manifest" && more) opt.manifest = argv[++i];
+        else if (a == "--out" && more) opt.out = argv[++i];
+        else if (a == "--port" && more) opt.port = argv[++i];
+        else if (a == "--pty") opt.pty = true;
+        else if (a == "--wait" && more) opt.wait_s = std::atoi(argv[++i]);
+        else if (a == "--score" && i + 2 < argc) { opt.score_manifest = argv[++i]; opt.score_capture = argv[++i]; }
+        else { Usage(); return 2; }
+    }
+    if (!opt.score_manifest.empty()) return Run_Score(opt);
+
+    int sinks = !opt.out.empty() + (int)opt.pty + !opt.port.empty();
+    if (sinks != 1 || opt.manifest.empty() || opt.baud <= 0) {
+        Usage();
+        return 2;
+    }
+    return Run_Generate(opt);
+}